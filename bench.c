@@ -0,0 +1,367 @@
+// bench.c
+
+#include "platform.h"
+#include "holographic.h"
+#include "bench.h"
+#include "vecmath.h"
+#include "prefetch.h"
+#include "coldstore.h"
+
+typedef void (*BenchFunction)(uint32_t size);
+
+static uint8_t bench_src[BENCH_MAX_BYTES] __attribute__((aligned(64)));
+static uint8_t bench_dst[BENCH_MAX_BYTES] __attribute__((aligned(64)));
+static float bench_vector_a[BENCH_MAX_DIMS] __attribute__((aligned(64)));
+static float bench_vector_b[BENCH_MAX_DIMS] __attribute__((aligned(64)));
+static int16_t bench_q15_a[BENCH_MAX_DIMS] __attribute__((aligned(64)));
+static int16_t bench_q15_b[BENCH_MAX_DIMS] __attribute__((aligned(64)));
+static float bench_math_in[BENCH_MATH_VALUES] __attribute__((aligned(64)));
+static float bench_math_out[BENCH_MATH_VALUES] __attribute__((aligned(64)));
+static uint8_t bench_evict[BENCH_EVICT_BYTES] __attribute__((aligned(64)));
+static holo_scalar_t bench_pattern_data[HOLOGRAPHIC_MAX_DIMENSIONS] __attribute__((aligned(64)));
+static holo_scalar_t bench_created_data[HOLOGRAPHIC_MAX_DIMENSIONS] __attribute__((aligned(64)));
+static HolographicVector bench_pattern = { bench_pattern_data, 0, 0, 0 };
+static HolographicVector bench_created = { bench_created_data, 0, 0, 0 };
+// bench_pattern's vector data, LZ4-compressed by bench_setup
+static uint8_t bench_lz4_data[BENCH_MAX_BYTES];
+static uint32_t bench_lz4_bytes;
+
+// Results land here so the measured calls cannot be optimized away
+static volatile uint32_t bench_sink;
+static volatile float bench_float_sink;
+
+// Reads one byte per line of a buffer larger than the LLC
+static void bench_evict_caches() {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH_EVICT_BYTES; i += 64) {
+        sum += ((volatile uint8_t*)bench_evict)[i];
+    }
+    bench_sink = sum;
+}
+
+// --- Cases ---
+
+static void bench_hash_data(uint32_t size) {
+    bench_sink = hash_data(bench_src, size);
+}
+
+static void bench_create_vector(uint32_t size) {
+    create_holographic_vector(&bench_created, bench_src, size);
+    bench_sink = bench_created.hash_signature;
+}
+
+static void bench_dot_product(uint32_t size) {
+    bench_float_sink = dot_product(bench_vector_a, bench_vector_b, size);
+}
+
+static void bench_cosine_similarity(uint32_t size) {
+    bench_float_sink = cosine_similarity(bench_vector_a, bench_vector_b, size);
+}
+
+static void bench_dot_product_q15(uint32_t size) {
+    bench_sink = dot_product_q15(bench_q15_a, bench_q15_b, size);
+}
+
+static void bench_cosine_similarity_q15(uint32_t size) {
+    bench_sink = cosine_similarity_q15(bench_q15_a, bench_q15_b, size);
+}
+
+// The fast-inverse-square-root sqrtf the core used before vecmath: one
+// Newton step on the 0x5f3759df guess, then a divide. Kept as the baseline.
+static float legacy_sqrtf(float x) {
+    if (x <= 0.0f) return 0.0f;
+    float x_half = 0.5f * x;
+    union { float f; int32_t i; } bits = { x };
+    bits.i = 0x5f3759df - (bits.i >> 1);
+    float y = bits.f;
+    y = y * (1.5f - x_half * y * y);
+    return 1.0f / y;
+}
+
+static void bench_legacy_sqrtf(uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) bench_math_out[i] = legacy_sqrtf(bench_math_in[i]);
+}
+
+static void bench_vm_sqrt(uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) bench_math_out[i] = vm_sqrt(bench_math_in[i]);
+}
+
+static void bench_vm_sqrt_batch(uint32_t size) {
+    vm_sqrt_batch(bench_math_out, bench_math_in, size);
+}
+
+static void bench_vm_rsqrt_batch(uint32_t size) {
+    vm_rsqrt_batch(bench_math_out, bench_math_in, size);
+}
+
+static void bench_vm_reciprocal_batch(uint32_t size) {
+    vm_reciprocal_batch(bench_math_out, bench_math_in, size);
+}
+
+static void bench_vm_normalize(uint32_t size) {
+    memcpy(bench_math_out, bench_math_in, size * sizeof(float));
+    vm_normalize(bench_math_out, size);
+}
+
+// Worst relative error over bench_math_in, in parts per billion. References
+// are the correctly rounded vm_sqrt and a plain division.
+static uint32_t bench_error_ppb(int kind) {
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < BENCH_MATH_VALUES; i++) {
+        float x = bench_math_in[i];
+        float value, exact;
+        if (kind == 0) {
+            value = legacy_sqrtf(x);
+            exact = vm_sqrt(x);
+        } else if (kind == 1) {
+            value = vm_rsqrt(x);
+            exact = 1.0f / vm_sqrt(x);
+        } else {
+            value = vm_reciprocal(x);
+            exact = 1.0f / x;
+        }
+        float error = (value - exact) / exact;
+        if (error < 0.0f) error = -error;
+        if (error > worst) worst = error;
+    }
+    return (uint32_t)(worst * 1e9f);
+}
+
+static void bench_report_accuracy(const char* name, uint32_t error_ppb) {
+    serial_print("[BENCH] ");
+    serial_print(name);
+    serial_print(" max_rel_error_ppb=");
+    serial_print_dec(error_ppb);
+    serial_print("\n");
+}
+
+// size = pool occupancy before the call; MAX_MEMORY_ENTRIES hits the
+// evict-oldest path
+static void bench_encode(uint32_t size) {
+    holo_system.memory_count = size;
+    encode_holographic_memory(&bench_pattern, &bench_pattern);
+}
+
+// size = entries scanned before the hit (the pool is searched newest first)
+static void bench_retrieve(uint32_t size) {
+    uint32_t hash = holo_system.memory_pool[MAX_MEMORY_ENTRIES - size].input_pattern.hash_signature;
+    bench_sink = retrieve_holographic_memory(hash) != 0;
+}
+
+// size = k; scans the whole filled pool
+static void bench_top_k(uint32_t size) {
+    uint32_t indices[HOLOGRAPHIC_TOP_K_MAX];
+    holo_alignment_t scores[HOLOGRAPHIC_TOP_K_MAX];
+    bench_sink = holographic_top_k(&bench_pattern, size, indices, scores);
+}
+
+// size = prefetch distance in bytes
+static void bench_top_k_distance(uint32_t size) {
+    prefetch_distance = size;
+    bench_top_k(8);
+}
+
+// A created vector as raw bytes: what the cold store sees before its
+// sparse encoding
+static void bench_lz4_compress(uint32_t size) {
+    bench_sink = lz4_compress((const uint8_t*)bench_pattern_data, size, bench_dst, BENCH_MAX_BYTES);
+}
+
+static void bench_lz4_decompress(uint32_t size) {
+    (void)size;
+    bench_sink = lz4_decompress(bench_lz4_data, bench_lz4_bytes, bench_dst, BENCH_MAX_BYTES);
+}
+
+static void bench_memcpy(uint32_t size) {
+    memcpy(bench_dst, bench_src, size);
+}
+
+static void bench_copy_bytes(uint32_t size) {
+    volatile uint8_t* dst = bench_dst;
+    for (uint32_t i = 0; i < size; i++) dst[i] = bench_src[i];
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+static void bench_rep_movsb(uint32_t size) {
+    void* dst = bench_dst;
+    const void* src = bench_src;
+    size_t count = size;
+    __asm__ volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(count) : : "memory");
+}
+
+static void bench_rep_movsd(uint32_t size) {
+    void* dst = bench_dst;
+    const void* src = bench_src;
+    size_t count = size / 4;
+    __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(count) : : "memory");
+}
+#endif
+
+// --- Harness ---
+
+static uint64_t bench_warm(BenchFunction function, uint32_t size, uint32_t iterations) {
+    function(size);
+    uint64_t best = ~(uint64_t)0;
+    for (int batch = 0; batch < BENCH_WARM_BATCHES; batch++) {
+        uint64_t start = platform_cycles();
+        for (uint32_t i = 0; i < iterations; i++) function(size);
+        uint64_t elapsed = platform_cycles() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return div64_u32(best, iterations);
+}
+
+static uint64_t bench_cold(BenchFunction function, uint32_t size) {
+    uint64_t samples[BENCH_COLD_SAMPLES];
+    for (int sample = 0; sample < BENCH_COLD_SAMPLES; sample++) {
+        bench_evict_caches();
+        uint64_t start = platform_cycles();
+        function(size);
+        samples[sample] = platform_cycles() - start;
+    }
+
+    for (int i = 1; i < BENCH_COLD_SAMPLES; i++) {
+        uint64_t value = samples[i];
+        int j = i;
+        for (; j > 0 && samples[j - 1] > value; j--) samples[j] = samples[j - 1];
+        samples[j] = value;
+    }
+    return samples[BENCH_COLD_SAMPLES / 2];
+}
+
+static void bench_report(const char* name, uint32_t size, const char* cache, uint64_t cycles) {
+    serial_print("[BENCH] ");
+    serial_print(name);
+    serial_print(" size=");
+    serial_print_dec(size);
+    serial_print(" cache=");
+    serial_print(cache);
+    serial_print(" cycles_per_op=");
+    serial_print_dec64(cycles);
+    serial_print("\n");
+}
+
+static void bench_case(const char* name, BenchFunction function, uint32_t size, uint32_t iterations) {
+    console_set_muted(1);
+    uint64_t warm = bench_warm(function, size, iterations);
+    uint64_t cold = bench_cold(function, size);
+    console_set_muted(0);
+
+    bench_report(name, size, "warm", warm);
+    bench_report(name, size, "cold", cold);
+}
+
+static void bench_setup() {
+    for (uint32_t i = 0; i < BENCH_MAX_BYTES; i++) {
+        bench_src[i] = (uint8_t)(i * 131 + 7);
+    }
+    for (uint32_t i = 0; i < BENCH_MAX_DIMS; i++) {
+        bench_vector_a[i] = (float)((int)(i % 17) - 8) / 8.0f;
+        bench_vector_b[i] = (float)((int)(i % 13) - 6) / 6.0f;
+        bench_q15_a[i] = (int16_t)(((int)(i % 17) - 8) * HOLO_Q15_MAX / 8);
+        bench_q15_b[i] = (int16_t)(((int)(i % 13) - 6) * HOLO_Q15_MAX / 6);
+    }
+    // Magnitudes spanning what cosine_similarity sees (1e-3 .. ~4e3)
+    for (uint32_t i = 0; i < BENCH_MATH_VALUES; i++) {
+        bench_math_in[i] = 0.001f + (float)(i * 7919 % 4096) * (float)(i + 1) / 1024.0f;
+    }
+    create_holographic_vector(&bench_pattern, "BENCH_PATTERN", strlen("BENCH_PATTERN") + 1);
+    bench_lz4_bytes = lz4_compress((const uint8_t*)bench_pattern_data, holo_dimensions * sizeof(holo_scalar_t),
+                                   bench_lz4_data, sizeof(bench_lz4_data));
+
+    // Fill the pool with distinct patterns so retrieve scans real entries
+    console_set_muted(1);
+    initialize_holographic_memory();
+    for (uint32_t i = 0; i < MAX_MEMORY_ENTRIES; i++) {
+        HolographicVector* pattern = holographic_scratch_vector(1);
+        create_holographic_vector(pattern, &i, sizeof(i));
+        encode_holographic_memory(pattern, pattern);
+    }
+    console_set_muted(0);
+}
+
+void bench_run_all() {
+    serial_print("[BENCH] BEGIN dimensions=");
+    serial_print_dec(holo_dimensions);
+    serial_print(" memory_entries=");
+    serial_print_dec(MAX_MEMORY_ENTRIES);
+    serial_print(" math=");
+    serial_print(vecmath_level_name());
+    serial_print(" prefetch_distance=");
+    serial_print_dec(prefetch_distance);
+    serial_print("\n");
+    bench_setup();
+
+    bench_case("hash_data", bench_hash_data, 16, 1024);
+    bench_case("hash_data", bench_hash_data, 256, 256);
+    bench_case("hash_data", bench_hash_data, 4096, 16);
+
+    bench_case("create_vector", bench_create_vector, 16, 64);
+
+    bench_case("dot_product", bench_dot_product, 128, 256);
+    bench_case("dot_product", bench_dot_product, holo_dimensions, 64);
+    bench_case("dot_product", bench_dot_product, BENCH_MAX_DIMS, 16);
+    bench_case("cosine_similarity", bench_cosine_similarity, 128, 256);
+    bench_case("cosine_similarity", bench_cosine_similarity, holo_dimensions, 64);
+    bench_case("cosine_similarity", bench_cosine_similarity, BENCH_MAX_DIMS, 16);
+    bench_case("dot_product_q15", bench_dot_product_q15, 128, 256);
+    bench_case("dot_product_q15", bench_dot_product_q15, holo_dimensions, 64);
+    bench_case("dot_product_q15", bench_dot_product_q15, BENCH_MAX_DIMS, 16);
+    bench_case("cosine_similarity_q15", bench_cosine_similarity_q15, 128, 256);
+    bench_case("cosine_similarity_q15", bench_cosine_similarity_q15, holo_dimensions, 64);
+    bench_case("cosine_similarity_q15", bench_cosine_similarity_q15, BENCH_MAX_DIMS, 16);
+
+    bench_case("legacy_sqrtf", bench_legacy_sqrtf, BENCH_MATH_VALUES, 16);
+    bench_case("vm_sqrt", bench_vm_sqrt, BENCH_MATH_VALUES, 16);
+    bench_case("vm_sqrt_batch", bench_vm_sqrt_batch, BENCH_MATH_VALUES, 16);
+    bench_case("vm_rsqrt_batch", bench_vm_rsqrt_batch, BENCH_MATH_VALUES, 16);
+    bench_case("vm_reciprocal_batch", bench_vm_reciprocal_batch, BENCH_MATH_VALUES, 16);
+    bench_case("vm_normalize", bench_vm_normalize, BENCH_MATH_VALUES, 16);
+    bench_report_accuracy("legacy_sqrtf", bench_error_ppb(0));
+    bench_report_accuracy("vm_rsqrt", bench_error_ppb(1));
+    bench_report_accuracy("vm_reciprocal", bench_error_ppb(2));
+
+    bench_case("retrieve", bench_retrieve, 1, 1024);
+    bench_case("retrieve", bench_retrieve, MAX_MEMORY_ENTRIES / 2, 256);
+    bench_case("retrieve", bench_retrieve, MAX_MEMORY_ENTRIES, 128);
+
+    // Prefetch on (detected distance), off, and swept across distances
+    uint32_t detected_distance = prefetch_distance;
+    bench_case("top_k", bench_top_k, 1, 8);
+    bench_case("top_k", bench_top_k, 8, 8);
+    prefetch_distance = 0;
+    bench_case("retrieve_noprefetch", bench_retrieve, MAX_MEMORY_ENTRIES, 128);
+    bench_case("top_k_noprefetch", bench_top_k, 8, 8);
+    for (uint32_t distance = 256; distance <= PREFETCH_DISTANCE_MAX; distance *= 2) {
+        bench_case("top_k_distance", bench_top_k_distance, distance, 8);
+    }
+    prefetch_distance = detected_distance;
+
+    bench_case("encode", bench_encode, 0, 256);
+    bench_case("encode", bench_encode, MAX_MEMORY_ENTRIES, 4);
+
+    bench_case("lz4_compress", bench_lz4_compress, holo_dimensions * sizeof(holo_scalar_t), 64);
+    bench_case("lz4_decompress", bench_lz4_decompress, holo_dimensions * sizeof(holo_scalar_t), 64);
+
+    bench_case("memcpy", bench_memcpy, 64, 1024);
+    bench_case("memcpy", bench_memcpy, 4096, 64);
+    bench_case("memcpy", bench_memcpy, BENCH_MAX_BYTES, 4);
+    bench_case("copy_bytes", bench_copy_bytes, 64, 1024);
+    bench_case("copy_bytes", bench_copy_bytes, 4096, 64);
+    bench_case("copy_bytes", bench_copy_bytes, BENCH_MAX_BYTES, 4);
+#if defined(__i386__) || defined(__x86_64__)
+    bench_case("rep_movsb", bench_rep_movsb, 64, 1024);
+    bench_case("rep_movsb", bench_rep_movsb, 4096, 64);
+    bench_case("rep_movsb", bench_rep_movsb, BENCH_MAX_BYTES, 4);
+    bench_case("rep_movsd", bench_rep_movsd, 64, 1024);
+    bench_case("rep_movsd", bench_rep_movsd, 4096, 64);
+    bench_case("rep_movsd", bench_rep_movsd, BENCH_MAX_BYTES, 4);
+#endif
+
+    console_set_muted(1);
+    initialize_holographic_memory();
+    console_set_muted(0);
+    hdr_reset(&encode_latency);
+    hdr_reset(&retrieve_latency);
+    serial_print("[BENCH] END\n");
+}
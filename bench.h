@@ -0,0 +1,44 @@
+// bench.h
+// Micro-benchmarks for the simulation core's hot paths. The same code runs
+// in the kernel (BENCH_ON_BOOT=1) and on the host (tools/holo_bench).
+//
+// Each case prints one line per cache state:
+//   [BENCH] <name> size=<n> cache=<warm|cold> cycles_per_op=<n>
+// and the math approximations one accuracy line each:
+//   [BENCH] <name> max_rel_error_ppb=<n>
+// Warm figures are the best batch average after a warm-up call. Cold
+// figures are the median of single calls issued right after sweeping an
+// eviction buffer larger than the last-level cache. Console output is muted
+// while timing, so logging inside the measured functions is not counted.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "platform.h"
+
+#ifndef BENCH_ON_BOOT
+#define BENCH_ON_BOOT 0
+#endif
+
+// Kernel only: run this many generations back to back after boot, print
+// [RESULT] lines and leave QEMU through isa-debug-exit (see `make bench`)
+#ifndef BENCH_GENERATIONS
+#define BENCH_GENERATIONS 0
+#endif
+
+#ifndef BENCH_EVICT_BYTES
+#define BENCH_EVICT_BYTES   (8u << 20)
+#endif
+
+#define BENCH_WARM_BATCHES  7
+#define BENCH_COLD_SAMPLES  15
+#define BENCH_MAX_BYTES     65536
+#define BENCH_MAX_DIMS      2048
+#define BENCH_MATH_VALUES   1024    // Inputs per math case; also the accuracy sweep
+
+// Runs every case between "[BENCH] BEGIN" and "[BENCH] END" lines. Leaves
+// the holographic memory pool reinitialized (empty) and the encode/retrieve
+// latency histograms reset.
+void bench_run_all();
+
+#endif
@@ -14,6 +14,12 @@ start:
 
     mov [boot_drive], dl
 
+    ; Fast A20 gate so the kernel's .bss above 1 MB is addressable
+    in al, 0x92
+    or al, 0x02
+    and al, 0xFE
+    out 0x92, al
+
     mov ax, 0x0003
     int 0x10
 
@@ -23,11 +29,11 @@ start:
     mov ax, HOLOGRAPHIC_KERNEL_OFFSET
     mov es, ax
     mov bx, 0x0000
-    mov dh, HOLOGRAPHIC_KERNEL_SECTORS
-    mov dl, [boot_drive]
     call disk_load
 
-    ; Load GDT and switch to protected mode
+    ; Load GDT and switch to protected mode; IRQs stay off until the
+    ; kernel has installed its own IDT
+    cli
     lgdt [gdt_descriptor]
     mov eax, cr0
     or eax, 0x1
@@ -62,17 +68,46 @@ print:
     popa
     ret
 
+; Reads HOLOGRAPHIC_KERNEL_SECTORS sectors starting at C/H/S 0/0/2 into ES:BX.
+; One sector per call keeps every read inside a track and away from 64 KB
+; DMA boundaries; ES advances by 512 bytes after each sector.
 disk_load:
     pusha
+.next_sector:
+    cmp word [sectors_left], 0
+    je .loaded
+    mov byte [read_retries], 3
+.retry:
     mov ah, 0x02       ; BIOS read sector function
-    mov al, dh         ; Number of sectors to read
-    mov ch, 0x00       ; Cylinder number
-    mov dh, 0x00       ; Head number
-    mov cl, 0x02       ; Starting sector
-
+    mov al, 1          ; Number of sectors to read
+    mov ch, [chs_cylinder]
+    mov cl, [chs_sector]
+    mov dh, [chs_head]
+    mov dl, [boot_drive]
     int 0x13           ; Call BIOS disk services
-    jc disk_error      ; Jump if carry flag set (error)
-
+    jnc .advance
+    dec byte [read_retries]
+    jz disk_error      ; Give up after three attempts
+    xor ah, ah         ; Reset the drive and try again
+    mov dl, [boot_drive]
+    int 0x13
+    jmp .retry
+.advance:
+    mov ax, es
+    add ax, 0x20
+    mov es, ax
+    dec word [sectors_left]
+    inc byte [chs_sector]
+    cmp byte [chs_sector], FLOPPY_SECTORS_PER_TRACK + 1
+    jne .next_sector
+    mov byte [chs_sector], 1
+    inc byte [chs_head]
+    cmp byte [chs_head], FLOPPY_HEADS
+    jne .next_sector
+    mov byte [chs_head], 0
+    inc byte [chs_cylinder]
+    jmp .next_sector
+.loaded:
     popa
     ret
 
@@ -84,6 +119,14 @@ disk_error:
 boot_msg db "[BOOT] Loading Holographic Kernel...", 0x0D, 0x0A, 0
 disk_err_msg db "[ERR] Disk read failed!", 0x0D, 0x0A, 0
 boot_drive db 0
+sectors_left dw HOLOGRAPHIC_KERNEL_SECTORS
+read_retries db 0
+chs_cylinder db 0
+chs_head db 0
+chs_sector db 2
+
+FLOPPY_SECTORS_PER_TRACK equ 18
+FLOPPY_HEADS equ 2
 
 HOLOGRAPHIC_KERNEL_OFFSET equ 0x1000
 
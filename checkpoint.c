@@ -0,0 +1,421 @@
+// checkpoint.c
+// Pools and the vector slab are streamed straight from/to their static
+// storage; only the
+// partial last sector of each region goes through a bounce buffer so the
+// device never DMAs past the end of a structure.
+//
+// With paging on, a save is a copy-on-write snapshot instead: the pages of
+// the four regions are made read-only in one pass over their page-table
+// entries, and that pass is the whole pause. A write to a protected page
+// faults, the page is copied to a shadow frame above the kernel image and
+// made writable again. The writer, run from the idle loop, streams each
+// region a page at a time from the shadow copy where one exists and from
+// the still-protected live page otherwise, so what reaches the disk is the
+// pools as they were at the snapshot instant.
+
+#include "kernel.h"
+#include "holographic.h"
+#include "virtio_blk.h"
+#include "paging.h"
+#include "coldstore.h"
+#include "checkpoint.h"
+#include "replay.h"
+
+#define SECTORS_FOR(bytes) (((bytes) + VIRTIO_BLK_SECTOR_SIZE - 1) / VIRTIO_BLK_SECTOR_SIZE)
+
+#define CHECKPOINT_REGIONS 4
+
+typedef struct {
+    uint8_t* base;
+    uint32_t size;
+    uint32_t lba;
+} CheckpointRegion;
+
+// Written by the fault handler, so it is page-aligned and padded to whole
+// pages: it must never share a page with the regions it protects
+typedef struct {
+    int active;
+    CheckpointRegion regions[CHECKPOINT_REGIONS];
+    uint32_t region;                // Region and byte offset the writer is at
+    uint32_t offset;
+    uint32_t region_hash;
+    uint32_t payload_hash;
+    CheckpointHeader header;        // Taken at the snapshot instant
+    uint32_t total_sectors;
+    uint32_t next_frame;            // Shadow frames are handed out upward from here
+    uint32_t copied_pages;
+    uint64_t start;
+    uint64_t pause_cycles;
+    // Shadow copy of each small page written to during the snapshot, 0 for none
+    uint32_t shadow_frame[PAGING_MAX_SMALL_TABLES * 1024];
+} __attribute__((aligned(PAGE_SIZE))) CheckpointSnapshot;
+
+static uint8_t bounce_sector[VIRTIO_BLK_SECTOR_SIZE] __attribute__((aligned(16)));
+static uint8_t stream_buffer[PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));
+static CheckpointSnapshot snapshot;
+
+// Per-region hashes are folded together with these multipliers
+static const uint32_t region_hash_mix[CHECKPOINT_REGIONS] = { 1, 16777619U, 2166136261U, 2654435761U };
+
+// On-disk order: header sector, holo_system, entity_pool, slab, cold store
+static void describe_regions(CheckpointRegion* regions) {
+    regions[0].base = (uint8_t*)&holo_system;
+    regions[0].size = sizeof(holo_system);
+    regions[1].base = (uint8_t*)entity_pool;
+    regions[1].size = sizeof(entity_pool);
+    regions[2].base = (uint8_t*)holographic_slab_base();
+    regions[2].size = holographic_slab_bytes();
+    regions[3].base = cold_store_base();
+    regions[3].size = cold_store_bytes();
+    uint32_t lba = CHECKPOINT_BASE_LBA + 1;
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        regions[r].lba = lba;
+        lba += SECTORS_FOR(regions[r].size);
+    }
+}
+
+static uint32_t total_sectors(const CheckpointRegion* regions) {
+    const CheckpointRegion* last = &regions[CHECKPOINT_REGIONS - 1];
+    return last->lba + SECTORS_FOR(last->size) - CHECKPOINT_BASE_LBA;
+}
+
+static uint32_t checkpoint_payload_hash() {
+    CheckpointRegion regions[CHECKPOINT_REGIONS];
+    describe_regions(regions);
+    uint32_t hash = 0;
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        hash ^= hash_data(regions[r].base, regions[r].size) * region_hash_mix[r];
+    }
+    return hash;
+}
+
+static void fill_header(CheckpointHeader* header, uint32_t generation) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, CHECKPOINT_MAGIC, 8);
+    header->version = CHECKPOINT_VERSION;
+    header->holo_system_size = sizeof(holo_system);
+    header->entity_pool_size = sizeof(entity_pool);
+    header->pool_base = (uint32_t)&holo_system;
+    header->dimensions = holo_dimensions;
+    header->slab_size = holographic_slab_bytes();
+    header->slab_base = (uint32_t)holographic_slab_base();
+    header->cold_store_size = cold_store_bytes();
+    header->active_entity_count = active_entity_count;
+    header->global_timestamp = holo_system.global_timestamp;
+    header->generation = generation;
+}
+
+// The header goes last so a torn snapshot is never mistaken for a valid one
+static int write_header(const CheckpointHeader* header) {
+    memset(bounce_sector, 0, sizeof(bounce_sector));
+    memcpy(bounce_sector, header, sizeof(*header));
+    if (virtio_blk_flush() != 0 ||
+        virtio_blk_write(CHECKPOINT_BASE_LBA, bounce_sector, 1) != 0 ||
+        virtio_blk_flush() != 0) {
+        serial_print("[CKPT] Error: header write failed.\n");
+        return 0;
+    }
+    return 1;
+}
+
+static int write_region(uint32_t lba, const void* region, uint32_t size) {
+    uint32_t full = size / VIRTIO_BLK_SECTOR_SIZE;
+    uint32_t tail = size % VIRTIO_BLK_SECTOR_SIZE;
+
+    if (full && virtio_blk_write(lba, region, full) != 0) return 0;
+    if (tail) {
+        memset(bounce_sector, 0, sizeof(bounce_sector));
+        memcpy(bounce_sector, (const uint8_t*)region + full * VIRTIO_BLK_SECTOR_SIZE, tail);
+        if (virtio_blk_write(lba + full, bounce_sector, 1) != 0) return 0;
+    }
+    return 1;
+}
+
+static int read_region(uint32_t lba, void* region, uint32_t size) {
+    uint32_t full = size / VIRTIO_BLK_SECTOR_SIZE;
+    uint32_t tail = size % VIRTIO_BLK_SECTOR_SIZE;
+
+    if (full && virtio_blk_read(lba, region, full) != 0) return 0;
+    if (tail) {
+        if (virtio_blk_read(lba + full, bounce_sector, 1) != 0) return 0;
+        memcpy((uint8_t*)region + full * VIRTIO_BLK_SECTOR_SIZE, bounce_sector, tail);
+    }
+    return 1;
+}
+
+// Pools were overwritten in place; leave them zeroed for a fresh initialization
+static void discard_partial_restore() {
+    memset(&holo_system, 0, sizeof(holo_system));
+    memset(entity_pool, 0, sizeof(entity_pool));
+}
+
+static void report_transfer(const char* what, uint32_t sectors, uint64_t cycles) {
+    serial_print("[CKPT] ");
+    serial_print(what);
+    serial_print(" ");
+    serial_print_dec(sectors);
+    serial_print(" sectors in ");
+    serial_print_dec((uint32_t)(cycles >> 10));
+    serial_print(" Kcycles\n");
+}
+
+static uint32_t page_floor(uint32_t address) {
+    return address & ~(uint32_t)(PAGE_SIZE - 1);
+}
+
+static uint32_t region_pages(const CheckpointRegion* region) {
+    uint32_t first = page_floor((uint32_t)region->base);
+    uint32_t end = page_floor((uint32_t)region->base + region->size + PAGE_SIZE - 1);
+    return (end - first) / PAGE_SIZE;
+}
+
+static int snapshot_covers(uint32_t page) {
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        uint32_t first = page_floor((uint32_t)snapshot.regions[r].base);
+        if (page >= first && page - first < region_pages(&snapshot.regions[r]) * PAGE_SIZE) return 1;
+    }
+    return 0;
+}
+
+// Page fault hook: preserve the page as it was at the snapshot instant,
+// then let the write through
+static int snapshot_write_fault(uint32_t address) {
+    uint32_t page = page_floor(address);
+    if (!snapshot.active || !snapshot_covers(page)) return 0;
+
+    uint32_t index = page >> PAGE_SHIFT;
+    if (!snapshot.shadow_frame[index]) {
+        memcpy((void*)snapshot.next_frame, (const void*)page, PAGE_SIZE);
+        snapshot.shadow_frame[index] = snapshot.next_frame;
+        snapshot.next_frame += PAGE_SIZE;
+        snapshot.copied_pages++;
+    }
+    paging_unprotect(page, PAGE_SIZE);
+    paging_invalidate(page);
+    return 1;
+}
+
+// Snapshot contents of [address, address + bytes). Interrupts stay off so
+// no handler can write a live page between the shadow check and the copy.
+static void copy_frozen(uint8_t* destination, uint32_t address, uint32_t bytes) {
+    uint32_t flags = interrupts_save_disable();
+    while (bytes) {
+        uint32_t page = page_floor(address);
+        uint32_t chunk = page + PAGE_SIZE - address;
+        if (chunk > bytes) chunk = bytes;
+        uint32_t frame = snapshot.shadow_frame[page >> PAGE_SHIFT];
+        memcpy(destination, (const void*)(frame ? frame + (address - page) : address), chunk);
+        destination += chunk;
+        address += chunk;
+        bytes -= chunk;
+    }
+    interrupts_restore(flags);
+}
+
+// Makes every snapshot page writable again and forgets the shadow copies
+static void snapshot_release() {
+    uint32_t flags = interrupts_save_disable();
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        CheckpointRegion* region = &snapshot.regions[r];
+        paging_unprotect((uint32_t)region->base, region->size);
+        uint32_t first = (uint32_t)region->base >> PAGE_SHIFT;
+        memset(&snapshot.shadow_frame[first], 0, region_pages(region) * sizeof(snapshot.shadow_frame[0]));
+    }
+    paging_flush_tlb();
+    snapshot.active = 0;
+    interrupts_restore(flags);
+}
+
+static int snapshot_begin(uint32_t generation, uint32_t sectors) {
+    CheckpointRegion regions[CHECKPOINT_REGIONS];
+    describe_regions(regions);
+    uint32_t frames = 0;
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        if ((uint32_t)regions[r].base + regions[r].size > paging_small_limit()) return 0;
+        frames += region_pages(&regions[r]);
+    }
+    // Room to copy every page, so a write fault never has to fail
+    uint32_t frame_base = paging_free_base();
+    if (paging_ram_bytes() < frame_base || frames > (paging_ram_bytes() - frame_base) / PAGE_SIZE) return 0;
+
+    uint64_t start = rdtsc();
+    uint32_t flags = interrupts_save_disable();
+    memcpy(snapshot.regions, regions, sizeof(regions));
+    fill_header(&snapshot.header, generation);
+    snapshot.region = 0;
+    snapshot.offset = 0;
+    snapshot.region_hash = HASH_DATA_SEED;
+    snapshot.payload_hash = 0;
+    snapshot.total_sectors = sectors;
+    snapshot.next_frame = frame_base;
+    snapshot.copied_pages = 0;
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        paging_protect((uint32_t)regions[r].base, regions[r].size);
+    }
+    paging_flush_tlb();
+    paging_set_write_fault_hook(snapshot_write_fault);
+    snapshot.active = 1;
+    interrupts_restore(flags);
+
+    snapshot.start = start;
+    snapshot.pause_cycles = rdtsc() - start;
+    return 1;
+}
+
+static void snapshot_finish() {
+    snapshot_release();
+    snapshot.header.payload_hash = snapshot.payload_hash;
+    if (!write_header(&snapshot.header)) return;
+
+    report_transfer("Saved", snapshot.total_sectors, rdtsc() - snapshot.start);
+    serial_print("[CKPT] Snapshot pause ");
+    serial_print_dec((uint32_t)(snapshot.pause_cycles >> 10));
+    serial_print(" Kcycles, ");
+    serial_print_dec(snapshot.copied_pages);
+    serial_print(" pages copied on write\n");
+}
+
+int checkpoint_snapshot_active() {
+    return snapshot.active;
+}
+
+int checkpoint_snapshot_step() {
+    if (!snapshot.active) return 0;
+
+    for (uint32_t chunk = 0; chunk < CHECKPOINT_STREAM_CHUNKS && snapshot.region < CHECKPOINT_REGIONS; chunk++) {
+        CheckpointRegion* region = &snapshot.regions[snapshot.region];
+        uint32_t bytes = region->size - snapshot.offset;
+        if (bytes > PAGE_SIZE) bytes = PAGE_SIZE;
+        uint32_t sectors = SECTORS_FOR(bytes);
+
+        copy_frozen(stream_buffer, (uint32_t)region->base + snapshot.offset, bytes);
+        memset(stream_buffer + bytes, 0, sectors * VIRTIO_BLK_SECTOR_SIZE - bytes);
+        snapshot.region_hash = hash_data_update(snapshot.region_hash, stream_buffer, bytes);
+        if (bytes && virtio_blk_write(region->lba + snapshot.offset / VIRTIO_BLK_SECTOR_SIZE,
+                                      stream_buffer, sectors) != 0) {
+            serial_print("[CKPT] Error: pool write failed.\n");
+            snapshot_release();
+            return 0;
+        }
+
+        snapshot.offset += bytes;
+        if (snapshot.offset == region->size) {
+            snapshot.payload_hash ^= snapshot.region_hash * region_hash_mix[snapshot.region];
+            snapshot.region++;
+            snapshot.offset = 0;
+            snapshot.region_hash = HASH_DATA_SEED;
+        }
+    }
+
+    if (snapshot.region == CHECKPOINT_REGIONS) snapshot_finish();
+    return 1;
+}
+
+int checkpoint_save(uint32_t generation) {
+    if (!virtio_blk_present() || HOLOGRAPHIC_PAGED_MEMORY) return 0;
+    if (snapshot.active) {
+        serial_print("[CKPT] Previous snapshot still being written, skipped.\n");
+        return 0;
+    }
+
+    CheckpointRegion regions[CHECKPOINT_REGIONS];
+    describe_regions(regions);
+    uint32_t sectors = total_sectors(regions);
+    if (CHECKPOINT_BASE_LBA + sectors > virtio_blk_capacity()) {
+        serial_print("[CKPT] Disk too small for checkpoint.\n");
+        return 0;
+    }
+    // The replay log sits at a fixed LBA behind the checkpoint; a larger
+    // pool or dimensionality must not write over it
+    if (CHECKPOINT_BASE_LBA + sectors > REPLAY_LOG_LBA) {
+        serial_print("[CKPT] Error: checkpoint of ");
+        serial_print_dec(sectors);
+        serial_print(" sectors would overwrite the replay log, skipped.\n");
+        return 0;
+    }
+
+    if (paging_enabled() && snapshot_begin(generation, sectors)) return 1;
+
+    uint64_t start = rdtsc();
+
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        if (!write_region(regions[r].lba, regions[r].base, regions[r].size)) {
+            serial_print("[CKPT] Error: pool write failed.\n");
+            return 0;
+        }
+    }
+
+    CheckpointHeader header;
+    fill_header(&header, generation);
+    header.payload_hash = checkpoint_payload_hash();
+    if (!write_header(&header)) return 0;
+
+    report_transfer("Saved", sectors, rdtsc() - start);
+    return 1;
+}
+
+int checkpoint_restore(uint32_t* generation) {
+    if (!virtio_blk_present()) return 0;
+    if (HOLOGRAPHIC_PAGED_MEMORY) {
+        serial_print("[CKPT] No restore with a paged memory pool.\n");
+        return 0;
+    }
+
+    uint64_t start = rdtsc();
+
+    if (virtio_blk_read(CHECKPOINT_BASE_LBA, bounce_sector, 1) != 0) return 0;
+
+    CheckpointHeader header;
+    memcpy(&header, bounce_sector, sizeof(header));
+    for (int i = 0; i < 8; i++) {
+        if (header.magic[i] != CHECKPOINT_MAGIC[i]) {
+            serial_print("[CKPT] No checkpoint on disk.\n");
+            return 0;
+        }
+    }
+    if (header.version != CHECKPOINT_VERSION ||
+        header.holo_system_size != sizeof(holo_system) ||
+        header.entity_pool_size != sizeof(entity_pool) ||
+        header.pool_base != (uint32_t)&holo_system ||
+        header.dimensions != holo_dimensions ||
+        header.slab_size != holographic_slab_bytes() ||
+        header.slab_base != (uint32_t)holographic_slab_base() ||
+        header.cold_store_size != cold_store_bytes() ||
+        header.active_entity_count > MAX_ENTITIES) {
+        serial_print("[CKPT] Checkpoint layout does not match this kernel.\n");
+        return 0;
+    }
+
+    // Binds the update buffers and scratch vectors to the slab; the pools and
+    // slab contents are then overwritten by the snapshot
+    initialize_holographic_memory();
+
+    CheckpointRegion regions[CHECKPOINT_REGIONS];
+    describe_regions(regions);
+    for (int r = 0; r < CHECKPOINT_REGIONS; r++) {
+        if (!read_region(regions[r].lba, regions[r].base, regions[r].size)) {
+            serial_print("[CKPT] Error: pool read failed.\n");
+            discard_partial_restore();
+            return 0;
+        }
+    }
+
+    if (checkpoint_payload_hash() != header.payload_hash) {
+        serial_print("[CKPT] Error: checkpoint hash mismatch, discarding.\n");
+        discard_partial_restore();
+        return 0;
+    }
+
+    active_entity_count = header.active_entity_count;
+    if (holographic_storage_rebuild() != 0) {
+        serial_print("[CKPT] Error: entity storage in the checkpoint is inconsistent, discarding.\n");
+        active_entity_count = 0;
+        discard_partial_restore();
+        return 0;
+    }
+    holo_system.global_timestamp = header.global_timestamp;
+    *generation = header.generation;
+
+    report_transfer("Restored", total_sectors(regions), rdtsc() - start);
+    return 1;
+}
@@ -0,0 +1,57 @@
+// checkpoint.h
+// Snapshot/restore of the holographic pools to the virtio-blk disk.
+//
+// With paging enabled checkpoint_save only write-protects the pool pages
+// and returns; checkpoint_snapshot_step() then writes the frozen image in
+// the background, CHECKPOINT_STREAM_CHUNKS pages per call, and reports
+//   [CKPT] Saved <n> sectors in <n> Kcycles
+//   [CKPT] Snapshot pause <n> Kcycles, <n> pages copied on write
+// once the header is down. Without paging the save is synchronous. A
+// checkpoint that would reach the replay log (REPLAY_LOG_LBA) is refused.
+//
+// Paged builds (PAGED_MEMORY=1) neither save nor restore. The memory-pool
+// vectors live in the pager's backing image. Evictions keep updating that
+// image in place after a snapshot, so a restore would pair the snapshot's
+// pools with newer vectors, and the payload hash would not notice.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "kernel.h"
+
+#define CHECKPOINT_MAGIC            "HOLOCKPT"
+#define CHECKPOINT_VERSION          6
+#define CHECKPOINT_BASE_LBA         0
+#define CHECKPOINT_INTERVAL         64     // Generations between snapshots
+#define CHECKPOINT_RESTORE_ON_BOOT  1
+#define CHECKPOINT_STREAM_CHUNKS    16      // 4 KB pages written per background step
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t holo_system_size;
+    uint32_t entity_pool_size;
+    uint32_t pool_base;             // Entity genomes point into holo_system
+    uint32_t dimensions;
+    uint32_t slab_size;
+    uint32_t slab_base;             // Vector data pointers point into the slab
+    uint32_t cold_store_size;
+    uint32_t active_entity_count;
+    uint32_t global_timestamp;
+    uint32_t generation;
+    uint32_t payload_hash;
+} CheckpointHeader;
+
+// Both return 1 on success and 0 when no disk is present or I/O fails.
+// A failed restore leaves the caller to initialize the pools from scratch.
+// A save that started a snapshot returns 1; one made while the previous
+// snapshot is still being written is skipped and returns 0.
+int checkpoint_save(uint32_t generation);
+int checkpoint_restore(uint32_t* generation);
+
+// Writes the next pages of a snapshot in progress; returns 0 when there is
+// none (or it has just failed)
+int checkpoint_snapshot_step();
+int checkpoint_snapshot_active();
+
+#endif
@@ -0,0 +1,342 @@
+// coldstore.c
+// A record is a ColdRecord header followed by the state encoding and then
+// the task encoding, padded to whole blocks. The LZ4 compressor is the
+// greedy single-probe kind: a 4-byte hash of every position, a match when
+// the bytes at the remembered position agree, extended as far as the block
+// rules allow (the last 5 bytes are literals, no match starts in the last
+// 12).
+
+#include "platform.h"
+#include "holographic.h"
+#include "coldstore.h"
+
+#define COLD_FORMAT_NONE    0
+#define COLD_FORMAT_SPARSE  1
+#define COLD_FORMAT_LZ4     2
+
+// Largest sparse encoding: the full bitmap plus every element
+#define COLD_SCRATCH_BYTES  (HOLOGRAPHIC_MAX_DIMENSIONS / 8 + HOLOGRAPHIC_MAX_DIMENSIONS * sizeof(holo_scalar_t))
+
+#define LZ4_MIN_MATCH       4
+#define LZ4_LAST_LITERALS   5
+#define LZ4_MATCH_LIMIT     12
+#define LZ4_MAX_OFFSET      65535
+#define LZ4_HASH_BITS       12
+
+typedef struct {
+    uint16_t blocks;
+    uint8_t state_format;
+    uint8_t task_format;
+    uint16_t state_bytes;
+    uint16_t task_bytes;
+} ColdRecord;
+
+static uint8_t arena[COLD_STORE_BLOCKS * COLD_BLOCK_BYTES] __attribute__((aligned(CACHE_LINE_SIZE)));
+static uint8_t block_used[COLD_STORE_BLOCKS];
+static uint8_t sparse_scratch[COLD_SCRATCH_BYTES];
+static uint8_t encoded[2][COLD_SCRATCH_BYTES];
+static uint16_t lz4_table[1 << LZ4_HASH_BITS];
+
+static uint32_t live_records = 0;
+static uint32_t used_blocks = 0;
+static uint32_t freezes = 0;
+static uint32_t thaws = 0;
+static uint32_t full_count = 0;
+static uint64_t raw_total = 0;
+static uint64_t sparse_total = 0;
+static uint64_t stored_total = 0;
+
+// --- LZ4 block format ---
+static uint32_t read32(const uint8_t* bytes) {
+    return bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint32_t lz4_hash(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+static uint8_t* lz4_write_length(uint8_t* output, uint32_t length) {
+    while (length >= 255) {
+        *output++ = 255;
+        length -= 255;
+    }
+    *output++ = (uint8_t)length;
+    return output;
+}
+
+// One sequence: literals, then a match unless match_length is 0. Returns
+// 0 when it would not fit before `end`.
+static uint8_t* lz4_sequence(uint8_t* output, uint8_t* end, const uint8_t* literals, uint32_t literal_count,
+                             uint32_t offset, uint32_t match_length) {
+    uint32_t worst = 1 + literal_count / 255 + 1 + literal_count + 2 + match_length / 255 + 1;
+    if (worst > (uint32_t)(end - output)) return 0;
+
+    uint8_t* token = output++;
+    *token = (uint8_t)((literal_count < 15 ? literal_count : 15) << 4);
+    if (literal_count >= 15) output = lz4_write_length(output, literal_count - 15);
+    memcpy(output, literals, literal_count);
+    output += literal_count;
+
+    if (match_length) {
+        uint32_t extra = match_length - LZ4_MIN_MATCH;
+        *output++ = (uint8_t)offset;
+        *output++ = (uint8_t)(offset >> 8);
+        *token |= (uint8_t)(extra < 15 ? extra : 15);
+        if (extra >= 15) output = lz4_write_length(output, extra - 15);
+    }
+    return output;
+}
+
+uint32_t lz4_compress(const uint8_t* input, uint32_t size, uint8_t* output, uint32_t capacity) {
+    uint8_t* out = output;
+    uint8_t* end = output + capacity;
+    uint32_t anchor = 0;
+
+    if (size > LZ4_MATCH_LIMIT) {
+        memset(lz4_table, 0, sizeof(lz4_table));
+        uint32_t match_end = size - LZ4_LAST_LITERALS;
+        uint32_t position = 0;
+        while (position + LZ4_MATCH_LIMIT < size) {
+            uint32_t sequence = read32(input + position);
+            uint32_t hash = lz4_hash(sequence);
+            uint32_t candidate = lz4_table[hash];   // Position + 1; 0 = empty
+            lz4_table[hash] = (uint16_t)(position + 1);
+            if (candidate == 0 || position - (candidate - 1) > LZ4_MAX_OFFSET ||
+                read32(input + candidate - 1) != sequence) {
+                position++;
+                continue;
+            }
+            candidate--;
+
+            uint32_t length = LZ4_MIN_MATCH;
+            while (position + length < match_end && input[candidate + length] == input[position + length]) length++;
+            out = lz4_sequence(out, end, input + anchor, position - anchor, position - candidate, length);
+            if (!out) return 0;
+            position += length;
+            anchor = position;
+        }
+    }
+
+    out = lz4_sequence(out, end, input + anchor, size - anchor, 0, 0);
+    return out ? (uint32_t)(out - output) : 0;
+}
+
+uint32_t lz4_decompress(const uint8_t* input, uint32_t size, uint8_t* output, uint32_t capacity) {
+    const uint8_t* in = input;
+    const uint8_t* in_end = input + size;
+    uint32_t produced = 0;
+
+    while (in < in_end) {
+        uint8_t token = *in++;
+        uint32_t literals = token >> 4;
+        if (literals == 15) {
+            uint8_t byte;
+            do {
+                if (in >= in_end) return 0;
+                byte = *in++;
+                literals += byte;
+            } while (byte == 255);
+        }
+        if (literals > (uint32_t)(in_end - in) || literals > capacity - produced) return 0;
+        memcpy(output + produced, in, literals);
+        in += literals;
+        produced += literals;
+        if (in == in_end) break;        // The last sequence has no match
+
+        if (in_end - in < 2) return 0;
+        uint32_t offset = in[0] | ((uint32_t)in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > produced) return 0;
+        uint32_t length = token & 15;
+        if (length == 15) {
+            uint8_t byte;
+            do {
+                if (in >= in_end) return 0;
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > capacity - produced) return 0;
+        // Byte by byte: the match may overlap what it is producing
+        for (uint32_t i = 0; i < length; i++, produced++) {
+            output[produced] = output[produced - offset];
+        }
+    }
+    return produced;
+}
+
+// --- Sparse encoding ---
+static uint32_t sparse_encode(const holo_scalar_t* data, uint8_t* output) {
+    uint32_t bitmap_bytes = holo_dimensions / 8;
+    uint8_t* values = output + bitmap_bytes;
+    memset(output, 0, bitmap_bytes);
+    for (uint32_t i = 0; i < holo_dimensions; i++) {
+        if (data[i] == 0) continue;
+        output[i >> 3] |= (uint8_t)(1u << (i & 7));
+        memcpy(values, &data[i], sizeof(holo_scalar_t));
+        values += sizeof(holo_scalar_t);
+    }
+    return (uint32_t)(values - output);
+}
+
+static int sparse_decode(const uint8_t* input, uint32_t size, holo_scalar_t* data) {
+    uint32_t bitmap_bytes = holo_dimensions / 8;
+    if (size < bitmap_bytes) return -1;
+    const uint8_t* values = input + bitmap_bytes;
+    const uint8_t* end = input + size;
+    for (uint32_t i = 0; i < holo_dimensions; i++) {
+        if (input[i >> 3] & (1u << (i & 7))) {
+            if (end - values < (int)sizeof(holo_scalar_t)) return -1;
+            memcpy(&data[i], values, sizeof(holo_scalar_t));
+            values += sizeof(holo_scalar_t);
+        } else {
+            data[i] = 0;
+        }
+    }
+    return values == end ? 0 : -1;
+}
+
+// Encodes into encoded[slot]; returns the size and sets *format. The
+// sparse size is added to *sparse_bytes.
+static uint32_t encode_vector(const holo_scalar_t* data, uint32_t slot, uint8_t* format, uint32_t* sparse_sum) {
+    uint32_t sparse_bytes = sparse_encode(data, sparse_scratch);
+    *sparse_sum += sparse_bytes;
+    uint32_t compressed = lz4_compress(sparse_scratch, sparse_bytes, encoded[slot], sparse_bytes - 1);
+    if (compressed) {
+        *format = COLD_FORMAT_LZ4;
+        return compressed;
+    }
+    memcpy(encoded[slot], sparse_scratch, sparse_bytes);
+    *format = COLD_FORMAT_SPARSE;
+    return sparse_bytes;
+}
+
+static int decode_vector(const uint8_t* input, uint32_t size, uint8_t format, holo_scalar_t* data) {
+    if (format == COLD_FORMAT_NONE) {
+        memset(data, 0, holo_dimensions * sizeof(holo_scalar_t));
+        return 0;
+    }
+    if (format == COLD_FORMAT_SPARSE) return sparse_decode(input, size, data);
+    uint32_t sparse_bytes = lz4_decompress(input, size, sparse_scratch, sizeof(sparse_scratch));
+    if (sparse_bytes == 0) return -1;
+    return sparse_decode(sparse_scratch, sparse_bytes, data);
+}
+
+// --- Arena ---
+static uint32_t allocate_blocks(uint32_t count) {
+    uint32_t run = 0;
+    for (uint32_t block = 0; block < COLD_STORE_BLOCKS; block++) {
+        run = block_used[block] ? 0 : run + 1;
+        if (run == count) {
+            uint32_t first = block + 1 - count;
+            memset(&block_used[first], 1, count);
+            used_blocks += count;
+            return first;
+        }
+    }
+    return COLD_NO_RECORD;
+}
+
+static ColdRecord* record_at(uint32_t record) {
+    return (ColdRecord*)&arena[record];
+}
+
+uint32_t cold_store_put(const HolographicVector* state, const HolographicVector* task) {
+    ColdRecord header;
+    uint32_t sparse_bytes = 0;
+    header.state_bytes = (uint16_t)encode_vector(state->data, 0, &header.state_format, &sparse_bytes);
+    header.task_bytes = 0;
+    header.task_format = COLD_FORMAT_NONE;
+    if (task->valid) header.task_bytes = (uint16_t)encode_vector(task->data, 1, &header.task_format, &sparse_bytes);
+
+    uint32_t bytes = sizeof(ColdRecord) + header.state_bytes + header.task_bytes;
+    header.blocks = (uint16_t)((bytes + COLD_BLOCK_BYTES - 1) / COLD_BLOCK_BYTES);
+    uint32_t first = allocate_blocks(header.blocks);
+    if (first == COLD_NO_RECORD) {
+        full_count++;
+        return COLD_NO_RECORD;
+    }
+
+    uint32_t record = first * COLD_BLOCK_BYTES;
+    uint8_t* payload = &arena[record + sizeof(ColdRecord)];
+    memcpy(record_at(record), &header, sizeof(header));
+    memcpy(payload, encoded[0], header.state_bytes);
+    memcpy(payload + header.state_bytes, encoded[1], header.task_bytes);
+
+    live_records++;
+    freezes++;
+    raw_total += (task->valid ? 2 : 1) * holo_dimensions * sizeof(holo_scalar_t);
+    sparse_total += sparse_bytes;
+    stored_total += bytes;
+    return record;
+}
+
+int cold_store_take(uint32_t record, HolographicVector* state, HolographicVector* task) {
+    ColdRecord header;
+    memcpy(&header, record_at(record), sizeof(header));
+    const uint8_t* payload = &arena[record + sizeof(ColdRecord)];
+    int result = decode_vector(payload, header.state_bytes, header.state_format, state->data);
+    if (result == 0) {
+        result = decode_vector(payload + header.state_bytes, header.task_bytes, header.task_format, task->data);
+    }
+    cold_store_free(record);
+    thaws++;
+    return result;
+}
+
+void cold_store_free(uint32_t record) {
+    uint32_t blocks = record_at(record)->blocks;
+    memset(&block_used[record / COLD_BLOCK_BYTES], 0, blocks);
+    used_blocks -= blocks;
+    live_records--;
+}
+
+const void* cold_store_record(uint32_t record, uint32_t* bytes) {
+    ColdRecord* header = record_at(record);
+    *bytes = sizeof(ColdRecord) + header->state_bytes + header->task_bytes;
+    return header;
+}
+
+void cold_store_reset() {
+    memset(block_used, 0, sizeof(block_used));
+    live_records = 0;
+    used_blocks = 0;
+}
+
+void cold_store_claim(uint32_t record) {
+    uint32_t blocks = record_at(record)->blocks;
+    memset(&block_used[record / COLD_BLOCK_BYTES], 1, blocks);
+    used_blocks += blocks;
+    live_records++;
+}
+
+uint8_t* cold_store_base() {
+    return arena;
+}
+
+uint32_t cold_store_bytes() {
+    return sizeof(arena);
+}
+
+void cold_store_print_summary() {
+    serial_print("[COLD] records=");
+    serial_print_dec(live_records);
+    serial_print(" used_bytes=");
+    serial_print_dec(used_blocks * COLD_BLOCK_BYTES);
+    serial_print("/");
+    serial_print_dec(sizeof(arena));
+    serial_print(" raw_bytes=");
+    serial_print_dec64(raw_total);
+    serial_print(" sparse_bytes=");
+    serial_print_dec64(sparse_total);
+    serial_print(" stored_bytes=");
+    serial_print_dec64(stored_total);
+    serial_print(" freezes=");
+    serial_print_dec(freezes);
+    serial_print(" thaws=");
+    serial_print_dec(thaws);
+    serial_print(" full=");
+    serial_print_dec(full_count);
+    serial_print("\n");
+}
@@ -0,0 +1,66 @@
+// coldstore.h
+// Compressed store for the vectors of cold entities (a zswap for the slab).
+//
+// update_entities freezes an entity once it has been dormant, with no
+// interactions, for holo_cold_idle_generations generations: its state and
+// task vectors are compressed into one record here and its slab storage is
+// handed back, so the slab only has to hold the entities that are awake.
+// The entity is thawed the generation a neighbour wakes it.
+//
+// Each vector is first sparse-encoded (a bitmap of the non-zero dimensions,
+// then those elements in order; about 10% of the dimensions of a created
+// vector are set), then run through an LZ4 block compressor. Whichever of
+// the two is smaller is stored. Records are carved out of a fixed arena in
+// COLD_BLOCK_BYTES blocks, first fit. Record offsets do not depend on where
+// the arena is, so the arena is checkpointed as it is, and
+// cold_store_claim() rebuilds the block map from the records the restored
+// entities name. The byte counts in the summary are totals over every
+// freeze: raw vector data, its sparse encoding, and what was stored.
+//   [COLD] records=<n> used_bytes=<n>/<n> raw_bytes=<n> sparse_bytes=<n> stored_bytes=<n>
+//          freezes=<n> thaws=<n> full=<n>
+
+#ifndef COLDSTORE_H
+#define COLDSTORE_H
+
+#include "platform.h"
+#include "holographic.h"
+
+#define COLD_BLOCK_BYTES    64
+// Entities that have to be cold for the pool to fill, at least one
+#define COLD_STORE_ENTITIES (MAX_ENTITIES > HOLO_RESIDENT_ENTITIES ? MAX_ENTITIES - HOLO_RESIDENT_ENTITIES : 1)
+#ifndef COLD_STORE_BYTES
+// A quarter of the slab their vectors would take at the largest
+// dimensionality fw_cfg can pick at boot
+#define COLD_STORE_BYTES    (COLD_STORE_ENTITIES * 2 * HOLOGRAPHIC_MAX_DIMENSIONS * sizeof(holo_scalar_t) / 4)
+#endif
+#define COLD_STORE_BLOCKS   ((COLD_STORE_BYTES + COLD_BLOCK_BYTES - 1) / COLD_BLOCK_BYTES)
+#define COLD_NO_RECORD      0xFFFFFFFF
+
+// Compresses both vectors (the task vector only if valid) into a new
+// record; returns its offset, or COLD_NO_RECORD when the arena is full
+uint32_t cold_store_put(const HolographicVector* state, const HolographicVector* task);
+
+// Decodes a record into the vectors' data (an unstored task vector comes
+// back zeroed) and frees it; returns 0, or -1 for a corrupt record
+int cold_store_take(uint32_t record, HolographicVector* state, HolographicVector* task);
+void cold_store_free(uint32_t record);
+
+// Bytes of a record as stored, for hashing
+const void* cold_store_record(uint32_t record, uint32_t* bytes);
+
+// Empties the store; cold_store_claim marks a record of a restored arena
+// as in use again
+void cold_store_reset();
+void cold_store_claim(uint32_t record);
+
+uint8_t* cold_store_base();
+uint32_t cold_store_bytes();
+void cold_store_print_summary();
+
+// LZ4 block format, exposed for the benchmarks. Compress returns the
+// compressed size or 0 when it would exceed `capacity`; decompress returns
+// the decoded size or 0 for malformed input.
+uint32_t lz4_compress(const uint8_t* input, uint32_t size, uint8_t* output, uint32_t capacity);
+uint32_t lz4_decompress(const uint8_t* input, uint32_t size, uint8_t* output, uint32_t capacity);
+
+#endif
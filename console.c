@@ -0,0 +1,238 @@
+// console.c
+
+#include "kernel.h"
+#include "idt.h"
+#include "console.h"
+#include "holographic.h"
+#include "checkpoint.h"
+#include "profiler.h"
+#include "replay.h"
+
+#define COM1_PORT       0x3F8
+#define UART_IER        1
+#define UART_LSR        5
+#define UART_IER_RX     0x01
+#define UART_LSR_READY  0x01
+
+// Filled by the IRQ4 handler, drained by console_poll. Each index sits on
+// its own line, written only by its side.
+static volatile uint8_t rx_buffer[CONSOLE_RX_BUFFER];
+static volatile uint32_t rx_head __attribute__((aligned(CACHE_LINE_SIZE))) = 0;
+static uint32_t rx_dropped = 0;
+static volatile uint32_t rx_tail __attribute__((aligned(CACHE_LINE_SIZE))) = 0;
+
+static char line[CONSOLE_LINE_MAX + 1];
+static uint32_t line_length = 0;
+static char last_char = 0;
+
+static ConsoleTunable tunables[CONSOLE_MAX_TUNABLES];
+static uint32_t tunable_count = 0;
+
+static void console_rx_interrupt(InterruptFrame* frame) {
+    (void)frame;
+    while (inb(COM1_PORT + UART_LSR) & UART_LSR_READY) {
+        uint8_t c = inb(COM1_PORT);
+        if (rx_head - rx_tail < CONSOLE_RX_BUFFER) {
+            rx_buffer[rx_head % CONSOLE_RX_BUFFER] = c;
+            rx_head++;
+        } else {
+            rx_dropped++;
+        }
+    }
+}
+
+void console_init() {
+    irq_register(IRQ_COM1, console_rx_interrupt);
+    outb(COM1_PORT + UART_IER, UART_IER_RX);
+    serial_print("[CONSOLE] Ready; type 'help'\n");
+}
+
+int console_register_tunable(const char* name, uint32_t* value, uint32_t min, uint32_t max,
+                             const char* help) {
+    if (tunable_count >= CONSOLE_MAX_TUNABLES) return -1;
+    ConsoleTunable* tunable = &tunables[tunable_count++];
+    tunable->name = name;
+    tunable->value = value;
+    tunable->min = min;
+    tunable->max = max;
+    tunable->help = help;
+    return 0;
+}
+
+// --- Parsing ---
+
+static int string_equals(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Splits the line in place on spaces; returns the number of words
+static int split_words(char* text, char* words[], int max_words) {
+    int count = 0;
+    while (*text && count < max_words) {
+        while (*text == ' ') *text++ = '\0';
+        if (!*text) break;
+        words[count++] = text;
+        while (*text && *text != ' ') text++;
+    }
+    return count;
+}
+
+static int parse_u32(const char* text, uint32_t* value) {
+    uint32_t result = 0;
+    uint32_t base = 10;
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        text += 2;
+    }
+    if (!*text) return 0;
+    for (; *text; text++) {
+        uint32_t digit;
+        if (*text >= '0' && *text <= '9') digit = *text - '0';
+        else if (base == 16 && *text >= 'a' && *text <= 'f') digit = *text - 'a' + 10;
+        else if (base == 16 && *text >= 'A' && *text <= 'F') digit = *text - 'A' + 10;
+        else return 0;
+        if (result > (0xFFFFFFFFU - digit) / base) return 0;
+        result = result * base + digit;
+    }
+    *value = result;
+    return 1;
+}
+
+static ConsoleTunable* find_tunable(const char* name) {
+    for (uint32_t i = 0; i < tunable_count; i++) {
+        if (string_equals(tunables[i].name, name)) return &tunables[i];
+    }
+    return NULL;
+}
+
+// --- Commands ---
+
+static void print_tunable(const ConsoleTunable* tunable) {
+    serial_print("[CONSOLE] ");
+    serial_print(tunable->name);
+    serial_print("=");
+    serial_print_dec(*tunable->value);
+    serial_print(" (");
+    serial_print_dec(tunable->min);
+    serial_print("..");
+    serial_print_dec(tunable->max);
+    serial_print(") ");
+    serial_print(tunable->help);
+    serial_print("\n");
+}
+
+static void command_help() {
+    serial_print("[CONSOLE] commands: help | get [name] | set <name> <value> | stats | checkpoint"
+                 " | profile start|stop|reset|dump\n");
+    for (uint32_t i = 0; i < tunable_count; i++) {
+        print_tunable(&tunables[i]);
+    }
+}
+
+static void command_get(char* words[], int count) {
+    if (count < 2) {
+        for (uint32_t i = 0; i < tunable_count; i++) print_tunable(&tunables[i]);
+        return;
+    }
+    ConsoleTunable* tunable = find_tunable(words[1]);
+    if (!tunable) {
+        serial_print("[CONSOLE] Unknown tunable\n");
+        return;
+    }
+    print_tunable(tunable);
+}
+
+static void command_set(char* words[], int count) {
+    uint32_t value;
+    if (count < 3 || !parse_u32(words[2], &value)) {
+        serial_print("[CONSOLE] Usage: set <name> <value>\n");
+        return;
+    }
+    ConsoleTunable* tunable = find_tunable(words[1]);
+    if (!tunable) {
+        serial_print("[CONSOLE] Unknown tunable\n");
+        return;
+    }
+    if (value < tunable->min || value > tunable->max) {
+        serial_print("[CONSOLE] Out of range\n");
+        return;
+    }
+    *tunable->value = value;
+    print_tunable(tunable);
+}
+
+static void command_profile(char* words[], int count) {
+    if (count < 2) {
+        serial_print("[CONSOLE] Usage: profile start|stop|reset|dump\n");
+    } else if (string_equals(words[1], "start")) {
+        profiler_start();
+    } else if (string_equals(words[1], "stop")) {
+        profiler_stop();
+    } else if (string_equals(words[1], "reset")) {
+        profiler_reset();
+    } else if (string_equals(words[1], "dump")) {
+        profiler_dump();
+    } else {
+        serial_print("[CONSOLE] Usage: profile start|stop|reset|dump\n");
+        return;
+    }
+    serial_print("[CONSOLE] profiler ");
+    serial_print(profiler_running() ? "running\n" : "stopped\n");
+}
+
+static void execute_line(char* text, uint32_t generation) {
+    char* words[4];
+    int count = split_words(text, words, 4);
+    if (count == 0) return;
+
+    if (string_equals(words[0], "help")) {
+        command_help();
+    } else if (string_equals(words[0], "get")) {
+        command_get(words, count);
+    } else if (string_equals(words[0], "set")) {
+        command_set(words, count);
+    } else if (string_equals(words[0], "stats")) {
+        print_stats_summary(generation);
+    } else if (string_equals(words[0], "checkpoint")) {
+        if (checkpoint_save(generation)) replay_flush();
+        else serial_print("[CONSOLE] Checkpoint failed (no disk?)\n");
+    } else if (string_equals(words[0], "profile")) {
+        command_profile(words, count);
+    } else {
+        serial_print("[CONSOLE] Unknown command; type 'help'\n");
+    }
+}
+
+void console_poll(uint32_t generation) {
+    while (rx_tail != rx_head) {
+        char c = (char)rx_buffer[rx_tail % CONSOLE_RX_BUFFER];
+        rx_tail++;
+        char previous = last_char;
+        last_char = c;
+
+        if (c == '\n' && previous == '\r') {
+            continue;   // Second half of a CR LF terminal line ending
+        } else if (c == '\r' || c == '\n') {
+            serial_write('\n');
+            line[line_length] = '\0';
+            line_length = 0;
+            execute_line(line, generation);
+        } else if (c == 0x08 || c == 0x7F) {
+            if (line_length > 0) {
+                line_length--;
+                serial_print("\b \b");
+            }
+        } else if (c >= ' ' && line_length < CONSOLE_LINE_MAX) {
+            line[line_length++] = c;
+            serial_write(c);
+        }
+    }
+    if (rx_dropped) {
+        serial_print("[CONSOLE] Receive buffer overflow, input dropped\n");
+        rx_dropped = 0;
+    }
+}
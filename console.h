@@ -0,0 +1,50 @@
+// console.h
+// Command console on COM1. Bytes arrive through the UART receive interrupt
+// (IRQ4) into a ring buffer; console_poll() runs complete lines from the
+// main loop, so commands never execute in interrupt context.
+//
+//   help                       list commands and tunables
+//   get [name]                 show one or every tunable
+//   set <name> <value>         change a tunable (decimal or 0x hex)
+//   stats                      print the [STATS] summary now
+//   checkpoint                 save a checkpoint now
+//   profile start|stop|reset|dump
+//
+// Replies are prefixed "[CONSOLE]".
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "kernel.h"
+
+#define CONSOLE_RX_BUFFER   256     // Power of two
+#define CONSOLE_LINE_MAX    80
+#define CONSOLE_MAX_TUNABLES 16
+
+// log_mask bits: which periodic or per-generation output reaches the console
+#define LOG_CORE        0x01    // Entity update chatter ([GC], [SPAWN], [FIT], ...)
+#define LOG_STATS       0x02    // Periodic [STATS]/[HDR] summaries
+#define LOG_PROFILER    0x04    // Periodic [PROF] dumps
+#define LOG_CHECKPOINT  0x08    // Periodic [CKPT] saves
+#define LOG_ALL         0x0F
+
+typedef struct {
+    const char* name;
+    uint32_t* value;
+    uint32_t min;
+    uint32_t max;
+    const char* help;
+} ConsoleTunable;
+
+// Enables the receive interrupt. Call after idt_init and serial_init.
+void console_init();
+
+// The tunable must outlive the console; returns 0, or -1 when the table is full
+int console_register_tunable(const char* name, uint32_t* value, uint32_t min, uint32_t max,
+                             const char* help);
+
+// Runs every complete line received so far; generation is what stats and
+// checkpoint commands report against.
+void console_poll(uint32_t generation);
+
+#endif
@@ -0,0 +1,84 @@
+// fw_cfg.c
+
+#include "kernel.h"
+#include "fw_cfg.h"
+
+static void fw_cfg_select(uint16_t key) {
+    outw(FW_CFG_PORT_SELECTOR, key);
+}
+
+static void fw_cfg_read(void* buffer, uint32_t size) {
+    uint8_t* bytes = (uint8_t*)buffer;
+    for (uint32_t i = 0; i < size; i++) {
+        bytes[i] = inb(FW_CFG_PORT_DATA);
+    }
+}
+
+// Directory fields are big-endian
+static uint32_t fw_cfg_be32(const uint8_t* bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+           ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+static int fw_cfg_name_equals(const char* entry_name, const char* name) {
+    for (int i = 0; i < FW_CFG_MAX_FILE_NAME; i++) {
+        if (entry_name[i] != name[i]) return 0;
+        if (name[i] == '\0') return 1;
+    }
+    return 0;
+}
+
+int fw_cfg_present() {
+    char signature[4];
+    fw_cfg_select(FW_CFG_SIGNATURE);
+    fw_cfg_read(signature, sizeof(signature));
+    return signature[0] == 'Q' && signature[1] == 'E' && signature[2] == 'M' && signature[3] == 'U';
+}
+
+int fw_cfg_read_file(const char* name, void* buffer, uint32_t max_size) {
+    if (!fw_cfg_present()) return -1;
+
+    uint8_t count_bytes[4];
+    fw_cfg_select(FW_CFG_FILE_DIR);
+    fw_cfg_read(count_bytes, sizeof(count_bytes));
+    uint32_t count = fw_cfg_be32(count_bytes);
+
+    // Entry: size (be32), select (be16), reserved (16), name[56]
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t entry[8 + FW_CFG_MAX_FILE_NAME];
+        fw_cfg_read(entry, sizeof(entry));
+        const char* entry_name = (const char*)&entry[8];
+        if (!fw_cfg_name_equals(entry_name, name)) continue;
+
+        uint32_t size = fw_cfg_be32(entry);
+        uint16_t select = (uint16_t)((entry[4] << 8) | entry[5]);
+        if (size > max_size) size = max_size;
+        fw_cfg_select(select);
+        fw_cfg_read(buffer, size);
+        return (int)size;
+    }
+    return -1;
+}
+
+int fw_cfg_read_u32(const char* name, uint32_t* value) {
+    char text[16];
+    int size = fw_cfg_read_file(name, text, sizeof(text));
+    if (size <= 0) return 0;
+
+    uint32_t result = 0;
+    int digits = 0;
+    for (int i = 0; i < size; i++) {
+        char c = text[i];
+        if (c >= '0' && c <= '9') {
+            result = result * 10 + (uint32_t)(c - '0');
+            digits++;
+        } else if (c == '\n' || c == ' ' || c == '\r' || c == '\0') {
+            break;
+        } else {
+            return 0;
+        }
+    }
+    if (!digits) return 0;
+    *value = result;
+    return 1;
+}
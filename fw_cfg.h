@@ -0,0 +1,30 @@
+// fw_cfg.h
+// QEMU firmware configuration device (legacy I/O interface, ports
+// 0x510/0x511). Used to pass boot-time settings without a rebuild, e.g.
+//   qemu ... -fw_cfg name=opt/holo/dimensions,string=256
+
+#ifndef FW_CFG_H
+#define FW_CFG_H
+
+#include "kernel.h"
+
+#define FW_CFG_PORT_SELECTOR 0x510
+#define FW_CFG_PORT_DATA     0x511
+
+#define FW_CFG_SIGNATURE     0x0000
+#define FW_CFG_FILE_DIR      0x0019
+
+#define FW_CFG_MAX_FILE_NAME 56
+
+// Returns 1 when the device answers with the "QEMU" signature
+int fw_cfg_present();
+
+// Copies up to max_size bytes of the named file into buffer. Returns the
+// number of bytes copied, or -1 when the device or file is absent.
+int fw_cfg_read_file(const char* name, void* buffer, uint32_t max_size);
+
+// Reads a file holding a decimal number (trailing whitespace allowed).
+// Returns 1 and fills *value, or 0 when absent or malformed.
+int fw_cfg_read_u32(const char* name, uint32_t* value);
+
+#endif
@@ -0,0 +1,110 @@
+// genome.c
+// Hash collisions are resolved by comparing the bytes that were hashed, so
+// two entries never hold the same contents.
+
+#include "platform.h"
+#include "holographic.h"
+#include "genome.h"
+
+static uint32_t acquired = 0;
+static uint32_t deduplicated = 0;
+static uint32_t full_count = 0;
+
+static uint32_t genome_bytes() {
+    return holo_dimensions * sizeof(holo_scalar_t);
+}
+
+static GenomeEntry* entry_of(HolographicVector* genome) {
+    uint32_t index = (uint32_t)((uint8_t*)genome - (uint8_t*)holo_system.genomes) / sizeof(GenomeEntry);
+    return &holo_system.genomes[index];
+}
+
+static uint32_t* bucket_of(uint32_t hash) {
+    return &holo_system.genome_buckets[hash & (GENOME_BUCKETS - 1)];
+}
+
+static int same_bytes(const void* a, const void* b, uint32_t size) {
+    const uint8_t* x = (const uint8_t*)a;
+    const uint8_t* y = (const uint8_t*)b;
+    for (uint32_t i = 0; i < size; i++) {
+        if (x[i] != y[i]) return 0;
+    }
+    return 1;
+}
+
+void genome_store_reset() {
+    for (uint32_t g = 0; g < MAX_GENOMES; g++) {
+        holo_system.genomes[g].references = 0;
+        holo_system.genomes[g].next = GENOME_NONE;
+    }
+    for (uint32_t b = 0; b < GENOME_BUCKETS; b++) {
+        holo_system.genome_buckets[b] = GENOME_NONE;
+    }
+    holo_system.genome_count = 0;
+}
+
+HolographicVector* genome_acquire(const HolographicVector* vector) {
+    uint32_t hash = hash_data(vector->data, genome_bytes());
+    uint32_t* bucket = bucket_of(hash);
+    acquired++;
+
+    for (uint32_t g = *bucket; g != GENOME_NONE; g = holo_system.genomes[g].next) {
+        GenomeEntry* entry = &holo_system.genomes[g];
+        if (entry->content_hash == hash && same_bytes(entry->vector.data, vector->data, genome_bytes())) {
+            entry->references++;
+            deduplicated++;
+            return &entry->vector;
+        }
+    }
+
+    for (uint32_t g = 0; g < MAX_GENOMES; g++) {
+        GenomeEntry* entry = &holo_system.genomes[g];
+        if (entry->references) continue;
+        holographic_vector_copy(&entry->vector, vector);
+        entry->references = 1;
+        entry->content_hash = hash;
+        entry->next = *bucket;
+        *bucket = g;
+        holo_system.genome_count++;
+        return &entry->vector;
+    }
+    full_count++;
+    return 0;
+}
+
+void genome_retain(HolographicVector* genome) {
+    if (genome) entry_of(genome)->references++;
+}
+
+void genome_release(HolographicVector* genome) {
+    if (!genome) return;
+    GenomeEntry* entry = entry_of(genome);
+    if (--entry->references) return;
+
+    uint32_t index = (uint32_t)(entry - holo_system.genomes);
+    uint32_t* link = bucket_of(entry->content_hash);
+    while (*link != index) link = &holo_system.genomes[*link].next;
+    *link = entry->next;
+    entry->next = GENOME_NONE;
+    holo_system.genome_count--;
+}
+
+void genome_print_summary() {
+    uint32_t references = 0;
+    for (uint32_t g = 0; g < MAX_GENOMES; g++) {
+        references += holo_system.genomes[g].references;
+    }
+    serial_print("[GENOME] genomes=");
+    serial_print_dec(holo_system.genome_count);
+    serial_print("/");
+    serial_print_dec(MAX_GENOMES);
+    serial_print(" references=");
+    serial_print_dec(references);
+    serial_print(" acquired=");
+    serial_print_dec(acquired);
+    serial_print(" deduplicated=");
+    serial_print_dec(deduplicated);
+    serial_print(" full=");
+    serial_print_dec(full_count);
+    serial_print("\n");
+}
@@ -0,0 +1,38 @@
+// genome.h
+// Content-addressed, reference-counted genome store.
+//
+// Entity genomes used to point straight at a memory-pool pattern, which
+// moves when the pool rotates and cannot be told apart from an edited
+// copy. Genomes now live in holo_system.genomes: genome_acquire hashes a
+// vector's elements and returns the entry already holding the same
+// contents, or copies it into a free one. Every entity holding a genome
+// counts as one reference (a child inheriting its parent's genome retains
+// it), and the entry is freed when the last holder is collected. The store
+// therefore grows with the number of distinct genomes, up to MAX_GENOMES,
+// however large the population. It sits inside holo_system and its vectors
+// in the slab, so checkpoints carry it unchanged.
+//   [GENOME] genomes=<n>/<n> references=<n> acquired=<n> deduplicated=<n> full=<n>
+
+#ifndef GENOME_H
+#define GENOME_H
+
+#include "platform.h"
+#include "holographic.h"
+
+#define GENOME_NONE 0xFFFFFFFF
+
+// Empties the store; entry vectors must already be bound to the slab
+void genome_store_reset();
+
+// The store's genome with the contents of `vector`, added if new, with one
+// more reference; NULL (and counted under full=) when it is new and the
+// store is full
+HolographicVector* genome_acquire(const HolographicVector* vector);
+
+// Reference counting for genomes from genome_acquire; both accept NULL
+void genome_retain(HolographicVector* genome);
+void genome_release(HolographicVector* genome);
+
+void genome_print_summary();
+
+#endif
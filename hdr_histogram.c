@@ -0,0 +1,89 @@
+// hdr_histogram.c
+
+#include "platform.h"
+#include "hdr_histogram.h"
+
+static inline uint32_t msb_index(uint64_t value) {
+    uint32_t high = (uint32_t)(value >> 32);
+    uint32_t index;
+    if (high) {
+        __asm__("bsrl %1, %0" : "=r"(index) : "rm"(high));
+        return index + 32;
+    }
+    __asm__("bsrl %1, %0" : "=r"(index) : "rm"((uint32_t)value));
+    return index;
+}
+
+static uint32_t counts_index(uint64_t value) {
+    if (value < HDR_SUB_BUCKETS) return (uint32_t)value;
+
+    uint32_t bucket = msb_index(value) - HDR_SUB_BUCKET_BITS + 1;
+    if (bucket > HDR_MAX_MAGNITUDE - HDR_SUB_BUCKET_BITS) return HDR_COUNTS - 1;
+
+    uint32_t sub_bucket = (uint32_t)(value >> (bucket - 1)) - HDR_SUB_BUCKETS;
+    return bucket * HDR_SUB_BUCKETS + sub_bucket;
+}
+
+// Largest value that maps to the same counter as `index`
+static uint64_t highest_equivalent_value(uint32_t index) {
+    if (index < HDR_SUB_BUCKETS) return index;
+
+    uint32_t bucket = index / HDR_SUB_BUCKETS;
+    uint64_t sub_bucket = (index % HDR_SUB_BUCKETS) + HDR_SUB_BUCKETS;
+    uint64_t lowest = sub_bucket << (bucket - 1);
+    return lowest + ((uint64_t)1 << (bucket - 1)) - 1;
+}
+
+void hdr_init(HdrHistogram* histogram, const char* name) {
+    histogram->name = name;
+    hdr_reset(histogram);
+}
+
+void hdr_reset(HdrHistogram* histogram) {
+    histogram->total_count = 0;
+    histogram->min_value = 0;
+    histogram->max_value = 0;
+    memset(histogram->counts, 0, sizeof(histogram->counts));
+}
+
+void hdr_record(HdrHistogram* histogram, uint64_t value) {
+    histogram->counts[counts_index(value)]++;
+    if (histogram->total_count == 0 || value < histogram->min_value) histogram->min_value = value;
+    if (value > histogram->max_value) histogram->max_value = value;
+    histogram->total_count++;
+}
+
+uint64_t hdr_value_at_quantile(const HdrHistogram* histogram, uint32_t basis_points) {
+    if (histogram->total_count == 0) return 0;
+    if (basis_points >= 10000) return histogram->max_value;
+
+    uint64_t scaled = (uint64_t)histogram->total_count * basis_points + 9999;
+    uint32_t target = (uint32_t)div64_u32(scaled, 10000);
+    if (target == 0) target = 1;
+
+    uint32_t seen = 0;
+    for (uint32_t index = 0; index < HDR_COUNTS; index++) {
+        seen += histogram->counts[index];
+        if (seen >= target) {
+            uint64_t value = highest_equivalent_value(index);
+            return value < histogram->max_value ? value : histogram->max_value;
+        }
+    }
+    return histogram->max_value;
+}
+
+void hdr_print(const HdrHistogram* histogram) {
+    serial_print("[HDR] ");
+    serial_print(histogram->name);
+    serial_print(" count=");
+    serial_print_dec(histogram->total_count);
+    serial_print(" p50=");
+    serial_print_dec64(hdr_value_at_quantile(histogram, 5000));
+    serial_print(" p99=");
+    serial_print_dec64(hdr_value_at_quantile(histogram, 9900));
+    serial_print(" p99.9=");
+    serial_print_dec64(hdr_value_at_quantile(histogram, 9990));
+    serial_print(" max=");
+    serial_print_dec64(histogram->max_value);
+    serial_print(" cycles\n");
+}
@@ -0,0 +1,38 @@
+// hdr_histogram.h
+// Fixed-size log-linear latency histogram in the style of HdrHistogram.
+//
+// Values below 2^HDR_SUB_BUCKET_BITS are counted exactly; above that every
+// power-of-two range is split into 2^HDR_SUB_BUCKET_BITS linear sub-buckets,
+// giving about 3% relative precision up to 2^HDR_MAX_MAGNITUDE cycles.
+// Recording is a handful of integer ops and one counter increment.
+
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include "platform.h"
+
+#define HDR_SUB_BUCKET_BITS 5
+#define HDR_SUB_BUCKETS     (1 << HDR_SUB_BUCKET_BITS)
+#define HDR_MAX_MAGNITUDE   40       // ~6 minutes at 3 GHz
+#define HDR_COUNTS          ((HDR_MAX_MAGNITUDE - HDR_SUB_BUCKET_BITS + 1) * HDR_SUB_BUCKETS)
+
+typedef struct {
+    const char* name;
+    uint32_t total_count;
+    uint64_t min_value;
+    uint64_t max_value;
+    uint32_t counts[HDR_COUNTS];
+} HdrHistogram;
+
+void hdr_init(HdrHistogram* histogram, const char* name);
+void hdr_reset(HdrHistogram* histogram);
+void hdr_record(HdrHistogram* histogram, uint64_t value);
+
+// Highest value equivalent to the given quantile, expressed in basis points
+// (5000 = p50, 9900 = p99, 9990 = p99.9).
+uint64_t hdr_value_at_quantile(const HdrHistogram* histogram, uint32_t basis_points);
+
+// One "[HDR]" line: count, p50, p99, p99.9 and max.
+void hdr_print(const HdrHistogram* histogram);
+
+#endif
@@ -0,0 +1,1064 @@
+// holographic.c
+// Simulation core: holographic memory and the emergent entity update loop.
+// Freestanding C that reaches the outside world only through platform.h, so
+// it links into the kernel and into the host library (tools/holo_sim).
+
+#include "platform.h"
+#include "holographic.h"
+#include "phase.h"
+#include "hdr_histogram.h"
+#include "telemetry.h"
+#include "vecmath.h"
+#include "prefetch.h"
+#include "coldstore.h"
+#include "genome.h"
+
+struct HolographicSystem holo_system;
+
+struct Entity entity_pool[MAX_ENTITIES];
+uint32_t active_entity_count = 0;
+uint32_t holo_dimensions = HOLOGRAPHIC_DIMENSIONS;
+uint32_t holo_population_limit = MAX_ENTITIES;
+uint8_t holo_defer_gc = 0;
+HoloShard holo_shards[HOLO_MAX_SHARDS] = { { 0, MAX_ENTITIES, 0, 0, 0, 0, 0 } };
+uint32_t holo_shard_count = 1;
+uint32_t holo_balance_interval = HOLO_BALANCE_INTERVAL;
+uint32_t holo_cold_idle_generations = HOLO_COLD_IDLE_GENERATIONS;
+
+static uint32_t balance_countdown = HOLO_BALANCE_INTERVAL;
+static uint8_t balance_active = 0;
+static uint8_t balance_strikes = 0;     // Consecutive runs over the start threshold
+
+// Memory access latency in cycles; initialized and printed by the caller
+HdrHistogram encode_latency;
+HdrHistogram retrieve_latency;
+
+// Double buffers for update_entities. Static rather than on the stack: at
+// MAX_ENTITIES x HOLOGRAPHIC_DIMENSIONS they outgrow any reasonable frame.
+// The vector buffers belong to storage slots (below), not pool slots.
+static uint8_t next_active[MAX_ENTITIES];
+static HolographicVector next_state[HOLO_RESIDENT_ENTITIES];
+static uint8_t next_domain[MAX_ENTITIES];
+static HolographicVector next_task_vector[HOLO_RESIDENT_ENTITIES];
+static uint16_t next_path_id[MAX_ENTITIES];
+static holo_alignment_t next_task_alignment[MAX_ENTITIES];
+
+// --- Vector slab ---
+// One stretch of holo_dimensions elements per vector slot: memory entry
+// input/output, entity storage slots, scratch, and the genome store.
+// holo_dimensions is a multiple of 16, so every float slot starts on a cache
+// line (every Q1.15 slot on a half line), and at small dimensionalities the
+// whole working set packs densely.
+// Paged builds keep the memory-pool vectors out of it (holo_memory_store).
+#if HOLOGRAPHIC_PAGED_MEMORY
+#define HOLOGRAPHIC_SLAB_MEMORY_VECTORS 0
+#else
+#define HOLOGRAPHIC_SLAB_MEMORY_VECTORS (2 * MAX_MEMORY_ENTRIES)
+#endif
+#define HOLOGRAPHIC_SLAB_VECTORS (HOLOGRAPHIC_SLAB_MEMORY_VECTORS + 4 * HOLO_RESIDENT_ENTITIES + \
+                                  HOLOGRAPHIC_SCRATCH_VECTORS + MAX_GENOMES)
+
+static holo_scalar_t holo_slab[HOLOGRAPHIC_SLAB_VECTORS * HOLOGRAPHIC_MAX_DIMENSIONS] __attribute__((aligned(CACHE_LINE_SIZE)));
+static HolographicVector holo_scratch[HOLOGRAPHIC_SCRATCH_VECTORS];
+holo_scalar_t* holo_memory_store = 0;
+
+// Entity storage: HOLO_RESIDENT_ENTITIES slots of four vectors (state,
+// task, and their update buffers). An entity takes one when it is born or
+// thawed and hands it back when it freezes; a collected entity keeps its
+// slot for whatever is spawned into the same pool position next, which is
+// what the fixed binding before the cold store did.
+static holo_scalar_t* entity_storage = 0;
+static uint32_t storage_free[HOLO_RESIDENT_ENTITIES];
+static uint32_t storage_free_count = 0;
+
+int holographic_set_dimensions(uint32_t dimensions) {
+    if (dimensions < HOLOGRAPHIC_DIMENSION_ALIGN || dimensions > HOLOGRAPHIC_MAX_DIMENSIONS ||
+        dimensions % HOLOGRAPHIC_DIMENSION_ALIGN != 0) {
+        return -1;
+    }
+    holo_dimensions = dimensions;
+    return 0;
+}
+
+static holo_scalar_t* bind_vector(HolographicVector* vector, holo_scalar_t* storage) {
+    vector->data = storage;
+    vector->hash_signature = 0;
+    vector->active_dimensions = 0;
+    vector->valid = 0;
+    return storage + holo_dimensions;
+}
+
+static holo_scalar_t* storage_at(uint32_t slot) {
+    return entity_storage + slot * 4 * holo_dimensions;
+}
+
+// Storage slot of an entity that has one
+static uint32_t storage_slot(const struct Entity* entity) {
+    return (uint32_t)(entity->state.data - entity_storage) / (4 * holo_dimensions);
+}
+
+// Points the entity's vectors at a storage slot, keeping their metadata
+static void attach_storage(struct Entity* entity, uint32_t slot) {
+    entity->state.data = storage_at(slot);
+    entity->task_vector.data = entity->state.data + holo_dimensions;
+}
+
+static void release_storage(struct Entity* entity) {
+    storage_free[storage_free_count++] = storage_slot(entity);
+    entity->state.data = 0;
+    entity->task_vector.data = 0;
+}
+
+// A free storage slot, else one taken back from a collected entity past
+// the end of the pool; -1 when every slot is in use
+static int take_storage() {
+    if (storage_free_count) return storage_free[--storage_free_count];
+    for (uint32_t i = MAX_ENTITIES; i-- > active_entity_count;) {
+        struct Entity* collected = &entity_pool[i];
+        if (!collected->state.data) continue;
+        uint32_t slot = storage_slot(collected);
+        bind_vector(&collected->state, 0);
+        bind_vector(&collected->task_vector, 0);
+        return slot;
+    }
+    return -1;
+}
+
+// Whether take_storage would find a slot
+static int storage_available() {
+    if (storage_free_count) return 1;
+    for (uint32_t i = MAX_ENTITIES; i-- > active_entity_count;) {
+        if (entity_pool[i].state.data) return 1;
+    }
+    return 0;
+}
+
+// Gives a pool slot about to be (re)used storage if it has none; returns 0,
+// or -1 when none is free. The task vector of fresh storage starts unset.
+static int claim_storage(struct Entity* entity) {
+    if (entity->state.data) return 0;
+    int slot = take_storage();
+    if (slot < 0) return -1;
+    attach_storage(entity, slot);
+    entity->task_vector.valid = 0;
+    return 0;
+}
+
+// Gives every vector slot its own zeroed stretch of the slab, the first
+// HOLO_RESIDENT_ENTITIES pool slots their own entity storage, and empties
+// the cold store and the genome store
+static void bind_slab() {
+    memset(holo_slab, 0, holographic_slab_bytes());
+    holo_scalar_t* storage = HOLOGRAPHIC_PAGED_MEMORY ? holo_memory_store : holo_slab;
+    for (int i = 0; i < MAX_MEMORY_ENTRIES; i++) {
+        storage = bind_vector(&holo_system.memory_pool[i].input_pattern, storage);
+        storage = bind_vector(&holo_system.memory_pool[i].output_pattern, storage);
+    }
+    if (HOLOGRAPHIC_PAGED_MEMORY) storage = holo_slab;
+    entity_storage = storage;
+    for (int i = 0; i < HOLO_RESIDENT_ENTITIES; i++) {
+        storage = bind_vector(&entity_pool[i].state, storage);
+        storage = bind_vector(&entity_pool[i].task_vector, storage);
+        storage = bind_vector(&next_state[i], storage);
+        storage = bind_vector(&next_task_vector[i], storage);
+    }
+    for (int i = HOLO_RESIDENT_ENTITIES; i < MAX_ENTITIES; i++) {
+        bind_vector(&entity_pool[i].state, 0);
+        bind_vector(&entity_pool[i].task_vector, 0);
+    }
+    for (int i = 0; i < MAX_ENTITIES; i++) {
+        entity_pool[i].is_cold = 0;
+        entity_pool[i].cold_record = COLD_NO_RECORD;
+        entity_pool[i].genome = 0;
+    }
+    for (int i = 0; i < HOLOGRAPHIC_SCRATCH_VECTORS; i++) {
+        storage = bind_vector(&holo_scratch[i], storage);
+    }
+    for (int i = 0; i < MAX_GENOMES; i++) {
+        storage = bind_vector(&holo_system.genomes[i].vector, storage);
+    }
+    storage_free_count = 0;
+    cold_store_reset();
+    genome_store_reset();
+}
+
+int holographic_storage_rebuild() {
+    static uint8_t in_use[HOLO_RESIDENT_ENTITIES];
+    memset(in_use, 0, sizeof(in_use));
+    cold_store_reset();
+    for (uint32_t i = 0; i < MAX_ENTITIES; i++) {
+        struct Entity* entity = &entity_pool[i];
+        if (entity->is_cold) {
+            if (i >= active_entity_count || entity->cold_record >= cold_store_bytes()) return -1;
+            cold_store_claim(entity->cold_record);
+            continue;
+        }
+        if (!entity->state.data) continue;
+        uint32_t slot = storage_slot(entity);
+        if (entity->state.data < entity_storage || slot >= HOLO_RESIDENT_ENTITIES || in_use[slot]) return -1;
+        in_use[slot] = 1;
+    }
+    storage_free_count = 0;
+    for (uint32_t slot = HOLO_RESIDENT_ENTITIES; slot-- > 0;) {
+        if (!in_use[slot]) storage_free[storage_free_count++] = slot;
+    }
+    return 0;
+}
+
+HolographicVector* holographic_scratch_vector(uint32_t index) {
+    return &holo_scratch[index];
+}
+
+holo_scalar_t* holographic_slab_base() {
+    return holo_slab;
+}
+
+uint32_t holographic_slab_bytes() {
+    return HOLOGRAPHIC_SLAB_VECTORS * holo_dimensions * sizeof(holo_scalar_t);
+}
+
+uint32_t holographic_memory_store_bytes() {
+    return 2 * MAX_MEMORY_ENTRIES * holo_dimensions * sizeof(holo_scalar_t);
+}
+
+void holographic_vector_copy(HolographicVector* dst, const HolographicVector* src) {
+    dst->hash_signature = src->hash_signature;
+    dst->active_dimensions = src->active_dimensions;
+    dst->valid = src->valid;
+    if (src->valid && dst->data != src->data) {
+        memcpy(dst->data, src->data, holo_dimensions * sizeof(holo_scalar_t));
+    }
+}
+
+//---Hash function (FNV-1a) ---
+uint32_t hash_data(const void* input, uint32_t size) {
+    return hash_data_update(HASH_DATA_SEED, input, size);
+}
+
+uint32_t hash_data_update(uint32_t hash, const void* input, uint32_t size) {
+    const uint8_t* data = (const uint8_t*)input;
+    for (uint32_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+//---Vector kernels ---
+// Four interleaved accumulators, summed pairwise at the end, break the
+// floating-point add chain. The fixed-size variants below are stamped out
+// per common dimensionality with constant trip counts; the generic versions
+// use the same lane order, so results never depend on which one runs.
+static float cosine_finish(float dot, float mag1, float mag2) {
+    mag1 = (mag1 > 0) ? vm_sqrt(mag1) : 1.0f;
+    mag2 = (mag2 > 0) ? vm_sqrt(mag2) : 1.0f;
+    return (mag1 * mag2 > 0) ? (dot / (mag1 * mag2)) : 0.0f;
+}
+
+#define VECTOR_KERNEL_BODY_DOT(N)                                   \
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;               \
+    uint32_t d = 0;                                                 \
+    for (; d + 4 <= (N); d += 4) {                                  \
+        s0 += a[d] * b[d];                                          \
+        s1 += a[d + 1] * b[d + 1];                                  \
+        s2 += a[d + 2] * b[d + 2];                                  \
+        s3 += a[d + 3] * b[d + 3];                                  \
+    }                                                               \
+    for (; d < (N); d++) s0 += a[d] * b[d];
+
+#define VECTOR_KERNEL_BODY_COSINE(N)                                \
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;               \
+    float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;               \
+    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, b3 = 0.0f;               \
+    uint32_t d = 0;                                                 \
+    for (; d + 4 <= (N); d += 4) {                                  \
+        s0 += a[d] * b[d];         a0 += a[d] * a[d];         b0 += b[d] * b[d];             \
+        s1 += a[d + 1] * b[d + 1]; a1 += a[d + 1] * a[d + 1]; b1 += b[d + 1] * b[d + 1];     \
+        s2 += a[d + 2] * b[d + 2]; a2 += a[d + 2] * a[d + 2]; b2 += b[d + 2] * b[d + 2];     \
+        s3 += a[d + 3] * b[d + 3]; a3 += a[d + 3] * a[d + 3]; b3 += b[d + 3] * b[d + 3];     \
+    }                                                               \
+    for (; d < (N); d++) {                                          \
+        s0 += a[d] * b[d]; a0 += a[d] * a[d]; b0 += b[d] * b[d];    \
+    }
+
+#define DEFINE_VECTOR_KERNELS(N)                                                    \
+    static float dot_product_##N(const float* a, const float* b) {                  \
+        VECTOR_KERNEL_BODY_DOT(N)                                                   \
+        return (s0 + s1) + (s2 + s3);                                               \
+    }                                                                               \
+    static float cosine_similarity_##N(const float* a, const float* b) {            \
+        VECTOR_KERNEL_BODY_COSINE(N)                                                \
+        return cosine_finish((s0 + s1) + (s2 + s3), (a0 + a1) + (a2 + a3), (b0 + b1) + (b2 + b3)); \
+    }
+
+#define VECTOR_KERNEL_SIZES(X) X(128) X(256) X(512) X(1024) X(2048)
+
+VECTOR_KERNEL_SIZES(DEFINE_VECTOR_KERNELS)
+
+float dot_product(const float* a, const float* b, uint32_t dimensions) {
+    switch (dimensions) {
+#define DOT_PRODUCT_CASE(N) case N: return dot_product_##N(a, b);
+    VECTOR_KERNEL_SIZES(DOT_PRODUCT_CASE)
+#undef DOT_PRODUCT_CASE
+    default: {
+        VECTOR_KERNEL_BODY_DOT(dimensions)
+        return (s0 + s1) + (s2 + s3);
+    }
+    }
+}
+
+float cosine_similarity(const float* a, const float* b, uint32_t dimensions) {
+    switch (dimensions) {
+#define COSINE_SIMILARITY_CASE(N) case N: return cosine_similarity_##N(a, b);
+    VECTOR_KERNEL_SIZES(COSINE_SIMILARITY_CASE)
+#undef COSINE_SIMILARITY_CASE
+    default: {
+        VECTOR_KERNEL_BODY_COSINE(dimensions)
+        return cosine_finish((s0 + s1) + (s2 + s3), (a0 + a1) + (a2 + a3), (b0 + b1) + (b2 + b3));
+    }
+    }
+}
+
+//---Q1.15 vector kernels ---
+// Each pair of products is summed and shifted to Q20 before accumulating,
+// exactly what one pmaddwd lane followed by psrad produces, so the SSE2 and
+// scalar paths agree bit for bit.
+static int q15_use_sse2 = -1;
+
+static int32_t dot_product_q15_scalar(const int16_t* a, const int16_t* b, uint32_t dimensions) {
+    int32_t sum = 0;
+    for (uint32_t d = 0; d < dimensions; d += 2) {
+        int32_t pair = (int32_t)a[d] * b[d] + (int32_t)a[d + 1] * b[d + 1];
+        sum += pair >> HOLO_Q15_PRODUCT_SHIFT;
+    }
+    return sum;
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+typedef int16_t q15_v8hi __attribute__((vector_size(16)));
+typedef int32_t q15_v4si __attribute__((vector_size(16)));
+
+// Vector slots are 16-element aligned, so every load is an aligned movdqa.
+// The kernel's i386 stack is only guaranteed 4-byte alignment, hence the
+// realigning prologue for the 16-byte spills.
+__attribute__((target("sse2"), force_align_arg_pointer))
+static int32_t dot_product_q15_sse2(const int16_t* a, const int16_t* b, uint32_t dimensions) {
+    q15_v4si sum = { 0, 0, 0, 0 };
+    for (uint32_t d = 0; d < dimensions; d += 8) {
+        q15_v8hi va = *(const q15_v8hi*)&a[d];
+        q15_v8hi vb = *(const q15_v8hi*)&b[d];
+        q15_v4si pairs = __builtin_ia32_pmaddwd128(va, vb);
+        sum += pairs >> HOLO_Q15_PRODUCT_SHIFT;
+    }
+    return sum[0] + sum[1] + sum[2] + sum[3];
+}
+#endif
+
+// Dimensions are always a multiple of HOLOGRAPHIC_DIMENSION_ALIGN
+int32_t dot_product_q15(const int16_t* a, const int16_t* b, uint32_t dimensions) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (q15_use_sse2 < 0) q15_use_sse2 = platform_sse2_usable();
+    if (q15_use_sse2) return dot_product_q15_sse2(a, b, dimensions);
+#endif
+    return dot_product_q15_scalar(a, b, dimensions);
+}
+
+// Bitwise integer square root (no division, no FPU)
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+int32_t cosine_similarity_q15(const int16_t* a, const int16_t* b, uint32_t dimensions) {
+    int32_t dot = dot_product_q15(a, b, dimensions);
+    int32_t mag1 = dot_product_q15(a, a, dimensions);
+    int32_t mag2 = dot_product_q15(b, b, dimensions);
+    // Zero magnitudes count as 1.0, as in the float path
+    if (mag1 <= 0) mag1 = 1 << 20;
+    if (mag2 <= 0) mag2 = 1 << 20;
+
+    // sqrt(Q20 * Q20) = Q20; |dot| <= denominator, so dot << 24 stays in 55 bits
+    uint32_t denominator = isqrt64((uint64_t)mag1 * (uint64_t)mag2);
+    if (denominator == 0) return 0;
+    uint32_t magnitude = (uint32_t)(dot < 0 ? -dot : dot);
+    int32_t cosine = (int32_t)div64_u32((uint64_t)magnitude << 24, denominator);
+    return dot < 0 ? -cosine : cosine;
+}
+
+holo_alignment_t holographic_alignment(const HolographicVector* a, const HolographicVector* b) {
+#if HOLOGRAPHIC_FIXED_POINT
+    return cosine_similarity_q15(a->data, b->data, holo_dimensions);
+#else
+    return cosine_similarity(a->data, b->data, holo_dimensions);
+#endif
+}
+
+//---Holographic Memory Functions ---
+void create_holographic_vector(HolographicVector* vector, const void* input, uint32_t size) {
+    vector->hash_signature = hash_data(input, size);
+    vector->valid = 1;
+    vector->active_dimensions = 0;
+
+    uint32_t seed = vector->hash_signature;
+    for (uint32_t i = 0; i < holo_dimensions; i++) {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        if ((seed % 10) == 0) {
+            int32_t milli = (int32_t)(seed % 2000) - 1000;
+#if HOLOGRAPHIC_FIXED_POINT
+            int32_t q15 = milli * HOLO_Q15_ONE / 1000;
+            vector->data[i] = (int16_t)(q15 < -HOLO_Q15_MAX ? -HOLO_Q15_MAX : q15);
+#else
+            vector->data[i] = (float)milli / 1000.0f;
+#endif
+            vector->active_dimensions++;
+        } else {
+            vector->data[i] = 0;
+        }
+    }
+}
+
+void encode_holographic_memory(HolographicVector* input, HolographicVector* output) {
+    uint64_t start = platform_cycles();
+    if (holo_system.memory_count >= MAX_MEMORY_ENTRIES) {
+        // Rotate rather than copy vectors: the evicted entry's storage is reused
+        MemoryEntry evicted = holo_system.memory_pool[0];
+        for (int i = 0; i < MAX_MEMORY_ENTRIES - 1; i++) {
+            holo_system.memory_pool[i] = holo_system.memory_pool[i + 1];
+        }
+        holo_system.memory_pool[MAX_MEMORY_ENTRIES - 1] = evicted;
+        holo_system.memory_count = MAX_MEMORY_ENTRIES - 1;
+        serial_print("Warning: Holographic memory full, evicted oldest entry.\n");
+    }
+
+    MemoryEntry* entry = &holo_system.memory_pool[holo_system.memory_count];
+    holographic_vector_copy(&entry->input_pattern, input);
+    holographic_vector_copy(&entry->output_pattern, output);
+    entry->timestamp = holo_system.global_timestamp++;
+    entry->valid = 1;
+    holo_system.memory_count++;
+    hdr_record(&encode_latency, platform_cycles() - start);
+}
+
+// Bytes of vector data one slab slot holds at the current dimensionality
+static uint32_t vector_bytes() {
+    return holo_dimensions * sizeof(holo_scalar_t);
+}
+
+HolographicVector* retrieve_holographic_memory(uint32_t hash) {
+    uint64_t start = platform_cycles();
+    HolographicVector* found = 0;
+    // Newest first, so the look-ahead runs towards the start of the pool
+    int ahead = prefetch_distance / sizeof(MemoryEntry);
+    for (int i = holo_system.memory_count - 1; i >= 0; i--) {
+        if (ahead && i >= ahead) {
+            prefetch(&holo_system.memory_pool[i - ahead], PREFETCH_T0);
+        }
+        if (holo_system.memory_pool[i].valid &&
+            holo_system.memory_pool[i].input_pattern.hash_signature == hash) {
+            found = &holo_system.memory_pool[i].output_pattern;
+            break;
+        }
+    }
+    hdr_record(&retrieve_latency, platform_cycles() - start);
+    return found;
+}
+
+// Each comparison reads a whole input pattern, so the look-ahead is at
+// least one full vector: the next pattern's lines stream in while the
+// current one is being compared.
+uint32_t holographic_top_k(const HolographicVector* query, uint32_t k,
+                           uint32_t* indices, holo_alignment_t* scores) {
+    if (k > HOLOGRAPHIC_TOP_K_MAX) k = HOLOGRAPHIC_TOP_K_MAX;
+    uint32_t bytes = vector_bytes();
+    uint32_t ahead = prefetch_distance ? (prefetch_distance + bytes - 1) / bytes : 0;
+    int hint = prefetch_hint_for(holo_system.memory_count * bytes);
+    uint32_t found = 0;
+
+    for (uint32_t i = 0; i < holo_system.memory_count; i++) {
+        if (ahead && i + ahead < holo_system.memory_count) {
+            prefetch(&holo_system.memory_pool[i + ahead], hint);
+            prefetch_range(holo_system.memory_pool[i + ahead].input_pattern.data, bytes, hint);
+        }
+        MemoryEntry* entry = &holo_system.memory_pool[i];
+        if (!entry->valid) continue;
+        holo_alignment_t score = holographic_alignment(&entry->input_pattern, query);
+
+        // Insertion into the sorted (best first) result arrays
+        uint32_t slot = found < k ? found++ : k;
+        while (slot > 0 && scores[slot - 1] < score) {
+            if (slot < k) {
+                indices[slot] = indices[slot - 1];
+                scores[slot] = scores[slot - 1];
+            }
+            slot--;
+        }
+        if (slot < k) {
+            indices[slot] = i;
+            scores[slot] = score;
+        }
+    }
+    return found;
+}
+
+// Also lays out the vector slab for the current dimensionality, which
+// resets every entity slot as well
+void initialize_holographic_memory() {
+    print("Setting up holographic memory pool...\n");
+    holo_system.memory_count = 0;
+    holo_system.global_timestamp = 0;
+    for (int i = 0; i < MAX_MEMORY_ENTRIES; i++) {
+        holo_system.memory_pool[i].valid = 0;
+    }
+    bind_slab();
+    print("Holographic memory system online - ");
+    print_hex(holo_dimensions);
+    print(" dimensions available\n");
+}
+
+void load_initial_genome_vocabulary() {
+    const char* vocab[] = {
+        "ACTION_PRODUCE", "ACTION_CONSUME", "ACTION_SHARE",
+        "ACTION_ACTIVATE", "ACTION_DEACTIVATE",
+        "TRAIT_GENERIC", "TRAIT_ACTIVE", "TRAIT_DORMANT",
+        "SENSOR_NEIGHBOR_ACTIVE", "SENSOR_MEMORY_MATCH",
+        "GENOME_SIMPLE_RULE_1"
+    };
+    int num_vocab = sizeof(vocab) / sizeof(vocab[0]);
+
+    serial_print("Loading initial genome vocabulary...\n");
+    for (int i = 0; i < num_vocab; i++) {
+        HolographicVector* pattern = holographic_scratch_vector(0);
+        create_holographic_vector(pattern, vocab[i], strlen(vocab[i]) + 1);
+        encode_holographic_memory(pattern, pattern);
+        serial_print("  Loaded: ");
+        serial_print(vocab[i]);
+        serial_print("\n");
+    }
+    serial_print("Initial genome vocabulary loaded.\n");
+}
+
+void initialize_emergent_entities() {
+    serial_print("Initializing emergent entity pool...\n");
+
+    HolographicVector* simple_genome_rule = holographic_scratch_vector(0);
+    create_holographic_vector(simple_genome_rule, "GENOME_SIMPLE_RULE_1", strlen("GENOME_SIMPLE_RULE_1") + 1);
+    HolographicVector* genome_ptr = retrieve_holographic_memory(simple_genome_rule->hash_signature);
+
+    if (!genome_ptr) {
+        serial_print("Error: Initial genome rule not found in memory!\n");
+        encode_holographic_memory(simple_genome_rule, simple_genome_rule);
+        genome_ptr = retrieve_holographic_memory(simple_genome_rule->hash_signature);
+    }
+
+    for (int i = 0; i < INITIAL_ENTITIES; i++) {
+        if (active_entity_count >= MAX_ENTITIES) {
+            serial_print("Error: Cannot initialize more entities, pool full.\n");
+            break;
+        }
+
+        struct Entity* entity = &entity_pool[active_entity_count];
+        if (claim_storage(entity) != 0) {
+            serial_print("Error: Cannot initialize more entities, no free entity storage.\n");
+            break;
+        }
+        entity->id = active_entity_count;
+        entity->age = 0;
+        entity->interaction_count = 0;
+        entity->idle_generations = 0;
+        entity->is_active = 1;
+        create_holographic_vector(&entity->state, "TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
+        entity->genome = genome_ptr ? genome_acquire(genome_ptr) : 0;
+
+        for (int j = 0; j < MAX_ENTITY_DOMAINS; j++) {
+            entity->specialization_scores[j] = 0.1f;
+        }
+
+        entity->resource_allocation = 1.0f;
+        entity->confidence = 0.5f;
+        entity->fitness_score = 0;
+        entity->spawn_count = 0;
+        entity->marked_for_gc = 0;
+        entity->is_mutant = 0;
+        entity->task_alignment = 0;
+
+        entity->domain = ENTITY_DOMAIN_GENERIC;
+
+        active_entity_count++;
+        serial_print("  Initialized entity ID: ");
+        print_hex(entity->id);
+        serial_print("\n");
+    }
+
+    serial_print("Initialized ");
+    print_hex(active_entity_count);
+    serial_print(" emergent entities.\n");
+}
+
+const char* entity_domain_name(const struct Entity* entity) {
+    static const char* const names[] = { "generic", "emergent", "reactor", "sleeper" };
+    return entity->domain < sizeof(names) / sizeof(names[0]) ? names[entity->domain] : "unknown";
+}
+
+struct Entity* spawn_entity() {
+    if (active_entity_count >= holo_population_limit || active_entity_count >= MAX_ENTITIES) {
+        serial_print("Cannot spawn: Entity pool full.\n");
+        return NULL;
+    }
+
+    struct Entity* new_entity = &entity_pool[active_entity_count];
+    if (claim_storage(new_entity) != 0) {
+        serial_print("Cannot spawn: no free entity storage.\n");
+        return NULL;
+    }
+    new_entity->id = active_entity_count;
+    new_entity->age = 0;
+    new_entity->interaction_count = 0;
+    new_entity->idle_generations = 0;
+    new_entity->is_active = 1;
+    new_entity->fitness_score = 0;
+    new_entity->spawn_count = 0;
+    new_entity->marked_for_gc = 0;
+    new_entity->is_mutant = 0;
+
+    HolographicVector* simple_genome_rule = holographic_scratch_vector(0);
+    create_holographic_vector(simple_genome_rule, "GENOME_SIMPLE_RULE_1", strlen("GENOME_SIMPLE_RULE_1") + 1);
+    HolographicVector* genome_ptr = retrieve_holographic_memory(simple_genome_rule->hash_signature);
+
+    if (!genome_ptr) {
+        encode_holographic_memory(simple_genome_rule, simple_genome_rule);
+        genome_ptr = retrieve_holographic_memory(simple_genome_rule->hash_signature);
+    }
+
+    create_holographic_vector(&new_entity->state, "TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
+    new_entity->genome = genome_ptr ? genome_acquire(genome_ptr) : 0;
+
+    for (int i = 0; i < MAX_ENTITY_DOMAINS; i++) {
+        new_entity->specialization_scores[i] = 0.1f;
+    }
+
+    new_entity->resource_allocation = 1.0f;
+    new_entity->confidence = 0.5f;
+    new_entity->task_alignment = 0;
+
+    new_entity->domain = ENTITY_DOMAIN_EMERGENT;
+
+    active_entity_count++;
+    serial_print("[SPAWN] SUCCESS: New entity ID ");
+    print_hex(new_entity->id);
+    serial_print(" initialized.\n");
+    return new_entity;
+}
+
+void holographic_partition_shards(uint32_t count, const uint32_t* nodes) {
+    if (count < 1) count = 1;
+    if (count > HOLO_MAX_SHARDS) count = HOLO_MAX_SHARDS;
+    uint32_t first = 0;
+    for (uint32_t s = 0; s < count; s++) {
+        uint32_t end = (s == count - 1) ? MAX_ENTITIES : MAX_ENTITIES * (s + 1) / count;
+        holo_shards[s].first = first;
+        holo_shards[s].count = end - first;
+        holo_shards[s].node = nodes ? nodes[s] : 0;
+        holo_shards[s].visits = 0;
+        holo_shards[s].halo_reads = 0;
+        holo_shards[s].load = 0;
+        holo_shards[s].migrated = 0;
+        first = end;
+    }
+    holo_shard_count = count;
+}
+
+// Active entities in a shard's slot range
+static uint32_t shard_population(const HoloShard* shard) {
+    if (shard->first >= active_entity_count) return 0;
+    uint32_t end = shard->first + shard->count;
+    return (end < active_entity_count ? end : active_entity_count) - shard->first;
+}
+
+// Moves `slots` slots across the boundary between adjacent shards `from`
+// and `to`. Slots are only renumbered between owners; every slot keeps its
+// record and vector storage.
+static void migrate_slots(uint32_t from, uint32_t to, uint32_t slots) {
+    if (to == from + 1) {
+        holo_shards[from].count -= slots;
+        holo_shards[to].first -= slots;
+    } else {
+        holo_shards[from].first += slots;
+        holo_shards[from].count -= slots;
+    }
+    holo_shards[to].count += slots;
+    holo_shards[from].migrated += slots;
+    holo_shards[to].migrated += slots;
+
+    serial_print("[BALANCE] moved ");
+    serial_print_dec(slots);
+    serial_print(" slots from shard ");
+    serial_print_dec(from);
+    serial_print(" to ");
+    serial_print_dec(to);
+    serial_print("\n");
+}
+
+static void balance_shards(const uint64_t* shard_cycles) {
+    for (uint32_t s = 0; s < holo_shard_count; s++) {
+        holo_shards[s].load = (uint32_t)((3 * (uint64_t)holo_shards[s].load + shard_cycles[s]) / 4);
+    }
+    if (holo_shard_count < 2 || holo_balance_interval == 0 || --balance_countdown > 0) return;
+    balance_countdown = holo_balance_interval;
+
+    uint64_t total = 0;
+    uint32_t heaviest = 0;
+    for (uint32_t s = 0; s < holo_shard_count; s++) {
+        total += holo_shards[s].load;
+        if (holo_shards[s].load > holo_shards[heaviest].load) heaviest = s;
+    }
+    uint32_t mean = (uint32_t)div64_u32(total, holo_shard_count);
+    uint32_t percent = balance_active ? HOLO_BALANCE_STOP_PERCENT : HOLO_BALANCE_START_PERCENT;
+    if ((uint64_t)holo_shards[heaviest].load * 100 <= (uint64_t)mean * percent) {
+        balance_active = 0;
+        balance_strikes = 0;
+        return;
+    }
+    // A single spike (a logging-heavy generation, a GC sweep) is not an imbalance
+    if (!balance_active && ++balance_strikes < HOLO_BALANCE_CONFIRM_RUNS) return;
+    balance_active = 1;
+
+    // Hand the lighter neighbour half the difference between the two,
+    // priced at the heavy shard's average cost per active entity
+    HoloShard* heavy = &holo_shards[heaviest];
+    uint32_t population = shard_population(heavy);
+    if (population < 2) return;
+    uint32_t target = heaviest + 1;
+    if (heaviest == holo_shard_count - 1 ||
+        (heaviest > 0 && holo_shards[heaviest - 1].load < holo_shards[heaviest + 1].load)) {
+        target = heaviest - 1;
+    }
+    uint32_t per_entity = heavy->load / population;
+    uint32_t difference = heavy->load - holo_shards[target].load;
+    uint32_t slots = per_entity ? difference / 2 / per_entity : 0;
+    // Under one entity's worth: as even as entity granularity allows, and
+    // moving anyway would only bounce the entity back next run
+    if (slots < 1) {
+        balance_active = 0;
+        balance_strikes = 0;
+        return;
+    }
+    if (slots > population - 1) slots = population - 1;
+    // Giving away the top of the range moves load only once the idle slots
+    // above the last active entity have gone along
+    uint32_t end = heavy->first + heavy->count;
+    if (target == heaviest + 1 && end > active_entity_count) slots += end - active_entity_count;
+    migrate_slots(heaviest, target, slots);
+}
+
+uint32_t holographic_footprint_bytes() {
+    return sizeof(holo_system) + sizeof(entity_pool) +
+           sizeof(next_active) + sizeof(next_state) + sizeof(next_domain) +
+           sizeof(next_task_vector) + sizeof(next_path_id) + sizeof(next_task_alignment) +
+           holographic_slab_bytes() + cold_store_bytes();
+}
+
+// A cold entity's vectors are hashed in their stored form
+uint32_t holographic_entity_state_hash() {
+    uint32_t hash = hash_data(entity_pool, sizeof(entity_pool));
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (entity_pool[i].is_cold) {
+            uint32_t bytes;
+            const void* record = cold_store_record(entity_pool[i].cold_record, &bytes);
+            hash = (hash ^ hash_data(record, bytes)) * 16777619U;
+            continue;
+        }
+        hash = (hash ^ hash_data(entity_pool[i].state.data, holo_dimensions * sizeof(holo_scalar_t))) * 16777619U;
+        if (entity_pool[i].task_vector.valid) {
+            hash = (hash ^ hash_data(entity_pool[i].task_vector.data, holo_dimensions * sizeof(holo_scalar_t))) * 16777619U;
+        }
+    }
+    return hash;
+}
+
+#if HOLOGRAPHIC_FIXED_POINT
+#define HOLO_ALIGNMENT_HIGH (HOLO_Q24_ONE / 10 * 7)    // 0.7 in Q8.24
+#else
+#define HOLO_ALIGNMENT_HIGH 0.7f
+#endif
+
+// Moves a dormant entity's vectors into the cold store and frees its
+// storage; returns 0 when the store is full
+static int freeze_entity(struct Entity* entity) {
+    uint32_t record = cold_store_put(&entity->state, &entity->task_vector);
+    if (record == COLD_NO_RECORD) return 0;
+    uint32_t bytes;
+    cold_store_record(record, &bytes);
+    release_storage(entity);
+    entity->cold_record = record;
+    entity->is_cold = 1;
+    telemetry_trace(TRACE_FREEZE, entity->id, bytes);
+    serial_print("[COLD] Entity ");
+    print_hex(entity->id);
+    serial_print(" frozen.\n");
+    return 1;
+}
+
+// Brings a cold entity's vectors back into entity storage; returns 0 when
+// no storage is free, and the entity stays cold until a later generation
+static int thaw_entity(struct Entity* entity) {
+    int slot = take_storage();
+    if (slot < 0) return 0;
+    attach_storage(entity, slot);
+    if (cold_store_take(entity->cold_record, &entity->state, &entity->task_vector) != 0) {
+        serial_print("[COLD] Error: corrupt record for entity ");
+        print_hex(entity->id);
+        serial_print(", vectors reset.\n");
+        create_holographic_vector(&entity->state, "TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
+        entity->task_vector.valid = 0;
+    }
+    entity->is_cold = 0;
+    entity->cold_record = COLD_NO_RECORD;
+    telemetry_trace(TRACE_THAW, entity->id, 0);
+    return 1;
+}
+
+// --- EMERGENCE: Core Update Loop with CA Rules, Task Alignment, Mutation, GC ---
+void update_entities() {
+    memset(next_active, 0, sizeof(next_active));
+
+    phase_enter(PHASE_VOCAB_HASH);
+    HolographicVector* scratch = holographic_scratch_vector(0);
+    create_holographic_vector(scratch, "TRAIT_ACTIVE", strlen("TRAIT_ACTIVE") + 1);
+    uint32_t hash_trait_active = scratch->hash_signature;
+    create_holographic_vector(scratch, "TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
+    uint32_t hash_trait_dormant = scratch->hash_signature;
+    create_holographic_vector(scratch, "ACTION_SPAWN", strlen("ACTION_SPAWN") + 1);
+    uint32_t hash_action_spawn = scratch->hash_signature;
+    phase_exit();
+
+    serial_print("[GC] Starting entity update cycle...\n");
+
+    // The loop copies every entity's state and task vectors; fetch the
+    // records and vectors of the entities ahead while this one is processed
+    uint32_t bytes = vector_bytes();
+    uint32_t entity_bytes = sizeof(struct Entity) + 2 * bytes;
+    int ahead = prefetch_distance ? (prefetch_distance + entity_bytes - 1) / entity_bytes : 0;
+    int hint = prefetch_hint_for(active_entity_count * entity_bytes);
+    uint32_t shard_index = 0;
+    uint64_t shard_cycles[HOLO_MAX_SHARDS] = { 0 };
+    uint64_t shard_start = platform_cycles();
+
+    for (int i = 0; i < active_entity_count; i++) {
+        struct Entity* entity = &entity_pool[i];
+        // Shards are contiguous and in order; entities spawned during the
+        // loop land in the current shard or a later one
+        while ((uint32_t)i >= holo_shards[shard_index].first + holo_shards[shard_index].count &&
+               shard_index + 1 < holo_shard_count) {
+            uint64_t now = platform_cycles();
+            shard_cycles[shard_index] += now - shard_start;
+            shard_start = now;
+            shard_index++;
+        }
+        HoloShard* shard = &holo_shards[shard_index];
+        shard->visits++;
+        if (ahead && (uint32_t)(i + ahead) < active_entity_count) {
+            struct Entity* upcoming = &entity_pool[i + ahead];
+            prefetch_range(upcoming, sizeof(*upcoming), hint);
+            if (!upcoming->is_cold) {
+                prefetch_range(upcoming->state.data, bytes, hint);
+                prefetch_range(upcoming->task_vector.data, bytes, hint);
+            }
+        }
+        phase_enter(PHASE_CA_RULES);
+
+        int neighbor_active = 0;
+        int prev_idx = (i == 0) ? (active_entity_count - 1) : (i - 1);
+        int next_idx = (i == active_entity_count - 1) ? 0 : (i + 1);
+        if ((uint32_t)prev_idx - shard->first >= shard->count) shard->halo_reads++;
+        if ((uint32_t)next_idx - shard->first >= shard->count) shard->halo_reads++;
+
+        if (entity_pool[prev_idx].is_active) neighbor_active++;
+        if (entity_pool[next_idx].is_active) neighbor_active++;
+
+        // A neighbour is about to wake a cold entity; without free storage
+        // it sleeps on and Rule 1 waits for a later generation
+        if (entity->is_cold && neighbor_active > 0) thaw_entity(entity);
+
+        // A cold entity's vectors stay in the store and nothing below
+        // writes them
+        uint32_t slot = entity->is_cold ? 0 : storage_slot(entity);
+        next_active[i] = entity->is_active;
+        if (!entity->is_cold) holographic_vector_copy(&next_state[slot], &entity->state);
+        next_domain[i] = entity->domain;
+        if (!entity->is_cold) holographic_vector_copy(&next_task_vector[slot], &entity->task_vector);
+        next_path_id[i] = entity->path_id;
+        next_task_alignment[i] = entity->task_alignment;
+
+        entity->age++;
+        uint32_t interactions = entity->interaction_count;
+
+        // --- EMERGENCE: Cellular Automata Rule 1 - Activate if neighbor active ---
+        if (!entity->is_active && neighbor_active > 0 && !entity->is_cold) {
+            next_active[i] = 1;
+            create_holographic_vector(&next_state[slot], "TRAIT_ACTIVE", strlen("TRAIT_ACTIVE") + 1);
+            next_domain[i] = ENTITY_DOMAIN_REACTOR;
+            entity->interaction_count++;
+            telemetry_trace(TRACE_ACTIVATE, entity->id, neighbor_active);
+            serial_print("[SPAWN] Entity ");
+            print_hex(entity->id);
+            serial_print(" activated by neighbor.\n");
+        }
+        // --- EMERGENCE: Cellular Automata Rule 2 - Sleep if no neighbors ---
+        else if (entity->is_active && neighbor_active == 0) {
+            next_active[i] = 0;
+            create_holographic_vector(&next_state[slot], "TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
+            next_domain[i] = ENTITY_DOMAIN_SLEEPER;
+            entity->interaction_count++;
+            telemetry_trace(TRACE_SLEEP, entity->id, 0);
+            serial_print("[SLEEP] Entity ");
+            print_hex(entity->id);
+            serial_print(" going dormant (no neighbors).\n");
+        }
+        // --- EMERGENCE: Cellular Automata Rule 3 - Spawn if 2+ neighbors ---
+        // With every storage slot awake the child waits for one to free up
+        else if (entity->is_active && neighbor_active >= 2 && active_entity_count + 1 < holo_population_limit &&
+                 storage_available()) {
+            phase_enter(PHASE_SPAWN);
+            struct Entity* child = spawn_entity();
+            if (child) {
+                genome_release(child->genome);
+                child->genome = entity->genome;
+                genome_retain(child->genome);
+                child->is_mutant = 1;
+
+                // --- EMERGENCE: Simple Mutation - Flip one random dimension ---
+                holographic_vector_copy(&child->state, &entity->state);
+                if (holo_dimensions > 0) {
+                    int rand_dim = holo_system.global_timestamp % holo_dimensions;
+                    child->state.data[rand_dim] = -child->state.data[rand_dim];
+                }
+                holographic_vector_copy(&child->task_vector, &entity->task_vector);
+                child->path_id = entity->path_id;
+                child->task_alignment = entity->task_alignment;
+
+                telemetry_trace(TRACE_SPAWN, child->id, entity->id);
+                serial_print("[MUTATE] Spawned mutant child ID: ");
+                print_hex(child->id);
+                serial_print(" from parent ");
+                print_hex(entity->id);
+                serial_print("\n");
+                entity->spawn_count++;
+                entity->fitness_score += 10;
+            }
+            phase_exit();
+        }
+        if (next_active[i] || entity->interaction_count != interactions) {
+            entity->idle_generations = 0;
+        } else {
+            entity->idle_generations++;
+        }
+        phase_exit();
+
+        // --- EMERGENCE: Task Alignment via Cosine Similarity ---
+        // A cold entity has been idle since before it froze, so its vectors
+        // and their alignment are what they were last generation
+        phase_enter(PHASE_ALIGNMENT);
+        if (entity->task_vector.valid) {
+            if (!entity->is_cold) {
+                next_task_alignment[i] = holographic_alignment(&entity->state, &entity->task_vector);
+            }
+
+            if (next_task_alignment[i] > HOLO_ALIGNMENT_HIGH) {
+                entity->fitness_score += 5;
+                telemetry_trace(TRACE_FITNESS, entity->id, entity->fitness_score);
+                serial_print("[FIT] Entity ");
+                print_hex(entity->id);
+                serial_print(" alignment high. Fitness +5.\n");
+            }
+        }
+        phase_exit();
+
+        // --- EMERGENCE: Mark Low-Fitness/Old Entities for GC ---
+        phase_enter(PHASE_GC_MARK);
+        if (entity->age > 1000 && entity->fitness_score < 50) {
+            entity->marked_for_gc = 1;
+            telemetry_trace(TRACE_GC_MARK, entity->id, entity->fitness_score);
+            serial_print("[GC] Entity ");
+            print_hex(entity->id);
+            serial_print(" marked for garbage collection (low fitness).\n");
+        }
+        phase_exit();
+    }
+
+    shard_cycles[shard_index] += platform_cycles() - shard_start;
+
+    // --- EMERGENCE: Apply State Changes ---
+    phase_enter(PHASE_STATE_APPLY);
+    for (int i = 0; i < active_entity_count; i++) {
+        entity_pool[i].is_active = next_active[i];
+        if (!entity_pool[i].is_cold) {
+            uint32_t slot = storage_slot(&entity_pool[i]);
+            holographic_vector_copy(&entity_pool[i].state, &next_state[slot]);
+            holographic_vector_copy(&entity_pool[i].task_vector, &next_task_vector[slot]);
+        }
+        entity_pool[i].domain = next_domain[i];
+        entity_pool[i].path_id = next_path_id[i];
+        entity_pool[i].task_alignment = next_task_alignment[i];
+    }
+    phase_exit();
+
+    // --- EMERGENCE: Garbage Collection Phase ---
+    if (!holo_defer_gc) {
+        phase_enter(PHASE_GC_COMPACT);
+        int write_index = 0;
+        for (int i = 0; i < active_entity_count; i++) {
+            if (!entity_pool[i].marked_for_gc) {
+                // Swap rather than copy, so each slot keeps distinct vector storage
+                if (write_index != i) {
+                    struct Entity collected = entity_pool[write_index];
+                    entity_pool[write_index] = entity_pool[i];
+                    entity_pool[i] = collected;
+                }
+                write_index++;
+            } else {
+                genome_release(entity_pool[i].genome);
+                entity_pool[i].genome = 0;
+                if (entity_pool[i].is_cold) {
+                    cold_store_free(entity_pool[i].cold_record);
+                    entity_pool[i].is_cold = 0;
+                    entity_pool[i].cold_record = COLD_NO_RECORD;
+                }
+                telemetry_trace(TRACE_GC_COLLECT, entity_pool[i].id, entity_pool[i].age);
+                serial_print("[GC] Entity ");
+                print_hex(entity_pool[i].id);
+                serial_print(" collected.\n");
+            }
+        }
+        active_entity_count = write_index;
+        phase_exit();
+    }
+
+    // --- Cold store: freeze entities dormant for long enough ---
+    if (holo_cold_idle_generations) {
+        phase_enter(PHASE_GC_COMPACT);
+        for (uint32_t i = 0; i < active_entity_count; i++) {
+            struct Entity* entity = &entity_pool[i];
+            if (entity->is_cold || entity->is_active || entity->marked_for_gc ||
+                entity->idle_generations < holo_cold_idle_generations) {
+                continue;
+            }
+            if (!freeze_entity(entity)) break;      // Store full
+        }
+        phase_exit();
+    }
+    balance_shards(shard_cycles);
+    serial_print("[GC] Update cycle completed. Active entities: ");
+    print_hex(active_entity_count);
+    serial_print("\n");
+}
@@ -0,0 +1,321 @@
+// holographic.h
+// Holographic memory and emergent entity state shared across the kernel.
+
+#ifndef HOLOGRAPHIC_H
+#define HOLOGRAPHIC_H
+
+#include "platform.h"
+#include "hdr_histogram.h"
+
+// Enhanced Holographic Memory Configuration
+// The sizing constants can be overridden with -D (see tools/scaling_sweep.py).
+// HOLOGRAPHIC_DIMENSIONS is only the default: the dimensionality is chosen at
+// boot (holographic_set_dimensions) up to HOLOGRAPHIC_MAX_DIMENSIONS.
+#ifndef HOLOGRAPHIC_DIMENSIONS
+#define HOLOGRAPHIC_DIMENSIONS 512
+#endif
+#ifndef HOLOGRAPHIC_MAX_DIMENSIONS
+#if HOLOGRAPHIC_DIMENSIONS > 2048
+#define HOLOGRAPHIC_MAX_DIMENSIONS HOLOGRAPHIC_DIMENSIONS
+#else
+#define HOLOGRAPHIC_MAX_DIMENSIONS 2048
+#endif
+#endif
+#define HOLOGRAPHIC_DIMENSION_ALIGN 16      // Elements; one 64-byte line of floats
+
+// Vector element representation, fixed at build time (make FIXED_POINT=1).
+// Fixed point stores Q1.15 elements and Q8.24 alignments, and runs the whole
+// create/similarity/mutation path on integer arithmetic, so entity updates
+// never touch x87 or SSE floating-point state.
+#ifndef HOLOGRAPHIC_FIXED_POINT
+#define HOLOGRAPHIC_FIXED_POINT 0
+#endif
+
+#define HOLO_Q15_ONE        32768
+#define HOLO_Q15_MAX        32767       // -32768 is never stored, so negation cannot overflow
+#define HOLO_Q24_ONE        (1 << 24)
+// Products are Q30; each pair sum is shifted down to Q20 before it is
+// accumulated, which keeps a full 2048-element dot product inside int32
+#define HOLO_Q15_PRODUCT_SHIFT 10
+
+#if HOLOGRAPHIC_FIXED_POINT
+#if HOLOGRAPHIC_MAX_DIMENSIONS > 2048
+#error "Q15 accumulators are sized for at most 2048 dimensions"
+#endif
+typedef int16_t holo_scalar_t;          // Q1.15
+typedef int32_t holo_alignment_t;       // Q8.24
+#else
+typedef float holo_scalar_t;
+typedef float holo_alignment_t;
+#endif
+// Memory-pool vectors normally sit in the slab. A paged build (kernel only,
+// make PAGED_MEMORY=1) binds them into holo_memory_store instead, a window
+// the kernel's pager backs with disk, so MAX_MEMORY_ENTRIES can outgrow RAM.
+#ifndef HOLOGRAPHIC_PAGED_MEMORY
+#define HOLOGRAPHIC_PAGED_MEMORY 0
+#endif
+
+#define HOLOGRAPHIC_MEMORY_BASE 0xA0000
+#define HOLOGRAPHIC_MEMORY_SIZE 0x10000
+#ifndef MAX_MEMORY_ENTRIES
+#define MAX_MEMORY_ENTRIES 128
+#endif
+#ifndef MAX_ENTITIES
+#define MAX_ENTITIES 32
+#endif
+// Entities whose vectors the slab holds at once. The whole pool by
+// default, so the cold store never decides who lives. A build setting it
+// lower trades slab for cold-store arena: cold entities give their storage
+// back, so the population only outgrows this while the rest of it sleeps,
+// and an entity that cannot get storage stays unborn (or frozen) until
+// some is free.
+#ifndef HOLO_RESIDENT_ENTITIES
+#define HOLO_RESIDENT_ENTITIES MAX_ENTITIES
+#endif
+#ifndef INITIAL_ENTITIES
+#define INITIAL_ENTITIES 3
+#endif
+#define MAX_ENTITY_DOMAINS 8
+
+// Entity domain labels (Entity.domain); entity_domain_name spells them out
+#define ENTITY_DOMAIN_GENERIC   0
+#define ENTITY_DOMAIN_EMERGENT  1
+#define ENTITY_DOMAIN_REACTOR   2
+#define ENTITY_DOMAIN_SLEEPER   3
+// Distinct genomes the genome store (genome.h) holds; entities sharing
+// contents share one entry, so this does not follow MAX_ENTITIES
+#ifndef MAX_GENOMES
+#define MAX_GENOMES 16
+#endif
+#define GENOME_BUCKETS 32                   // Power of two
+
+// --- Modified Structures ---
+typedef struct {
+    uint32_t task_id;
+    uint32_t data[4];
+    uint8_t valid;
+} Task;
+
+// Vector storage lives in the slab (holographic.c): every vector slot in the
+// pools is bound once to its own aligned stretch of holo_dimensions
+// elements (64 bytes for float, 32 for Q1.15). Entity vectors have storage
+// only while the entity is warm; a cold entity's data pointers are null.
+// Assigning one HolographicVector to another would alias that storage, so
+// copy with holographic_vector_copy.
+typedef struct {
+    holo_scalar_t* data;
+    uint32_t hash_signature;
+    uint16_t active_dimensions;
+    uint8_t valid;
+} HolographicVector;
+
+// The retrieval scan reads valid and timestamp of every entry before it
+// touches a pattern, so they lead the struct
+typedef struct {
+    uint8_t valid;
+    uint32_t timestamp;
+    HolographicVector input_pattern;
+    HolographicVector output_pattern;
+} MemoryEntry;
+
+// One genome in the store, addressed by the hash of its elements. Entries
+// in the same bucket are chained through `next`.
+typedef struct {
+    uint32_t references;            // Entities holding it; 0 = free
+    uint32_t content_hash;
+    uint32_t next;
+    HolographicVector vector;
+} GenomeEntry;
+
+// --- EMERGENCE: Enhanced Entity Structure for True Emergence ---
+// Adds task vectors, fitness, mutation flags, and GC markers
+// Line-aligned. Everything update_entities, spawn and GC touch each
+// generation sits in the first cache line (64 bytes on i386); the
+// descriptive fields only read by stats and telemetry follow it.
+// `make layout-report` prints the resulting offsets.
+struct Entity {
+    // --- Hot: flags, counters and vector handles ---
+    uint8_t is_active;
+    uint8_t marked_for_gc;          // Garbage collection flag
+    uint8_t is_mutant;              // Mutation flag for debugging
+    uint8_t is_cold;                // Vectors frozen in the cold store (coldstore.h)
+    uint32_t id;
+    uint32_t age;
+    uint32_t interaction_count;
+    uint32_t idle_generations;      // Dormant with no interactions, in a row
+
+    // --- EMERGENCE: Evolution & Fitness ---
+    uint32_t fitness_score;         // Accumulated performance metric
+    uint32_t spawn_count;           // Number of children spawned
+
+    // --- EMERGENCE: Task & Path Assignment ---
+    uint16_t path_id;               // Logical path ID (e.g., 0xA1 = network path)
+    uint8_t domain;                 // ENTITY_DOMAIN_*, rewritten every generation
+    holo_alignment_t task_alignment; // Cosine similarity between state and task
+    HolographicVector* genome;      // Genome store entry (genome.h), shared
+    HolographicVector state;
+    HolographicVector task_vector;  // Assigned task encoded as vector
+
+    // --- Cold: descriptive fields, from the second line on ---
+    float specialization_scores[MAX_ENTITY_DOMAINS] __attribute__((aligned(CACHE_LINE_SIZE)));
+    float resource_allocation;
+    float confidence;
+    uint32_t cold_record;           // Cold store record while is_cold
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+struct HardwareInfo {
+    char cpu_vendor[13];
+    uint32_t cpu_features;
+    uint32_t memory_kb;
+    int device_count;
+};
+
+struct HolographicSystem {
+    MemoryEntry memory_pool[MAX_MEMORY_ENTRIES] __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t memory_count;
+    uint32_t global_timestamp;
+    GenomeEntry genomes[MAX_GENOMES];
+    uint32_t genome_buckets[GENOME_BUCKETS];    // First entry per bucket
+    uint32_t genome_count;
+};
+
+// Logical partition of entity_pool: the contiguous slots one core would
+// own. The kernel makes one shard per NUMA node (numa.c); hosted builds and
+// single-node machines run one shard covering the whole pool. update_entities
+// counts, per shard, the entities it visited and the neighbour reads that
+// crossed into another shard (the halo).
+//
+// Generation time is the slowest shard's time once cores run them in
+// parallel, so every holo_balance_interval generations the balancer moves
+// a contiguous range of slots from the heaviest shard to its lighter
+// neighbour. It starts when the heaviest load exceeds the mean by
+// HOLO_BALANCE_START_PERCENT on HOLO_BALANCE_CONFIRM_RUNS runs in a row
+// and keeps going until it is within
+// HOLO_BALANCE_STOP_PERCENT; in between nothing moves, so boundaries don't
+// chase noise. Each move hands the neighbour half the load difference
+// between the two, and the interval lets the smoothed loads settle before
+// the next one.
+#define HOLO_MAX_SHARDS             8
+#define HOLO_BALANCE_INTERVAL       16      // Generations between balancer runs; 0 = off
+#define HOLO_BALANCE_START_PERCENT  125
+#define HOLO_BALANCE_STOP_PERCENT   110
+#define HOLO_BALANCE_CONFIRM_RUNS   2
+
+typedef struct {
+    uint32_t first;             // First entity_pool slot
+    uint32_t count;             // Slots owned; the last shard runs to MAX_ENTITIES
+    uint32_t node;              // NUMA node of the core that owns it
+    uint32_t visits;            // Entity updates, cumulative
+    uint32_t halo_reads;        // Neighbour reads outside the shard, cumulative
+    uint32_t load;              // Cycles per generation in its entities, smoothed
+    uint32_t migrated;          // Slots moved in or out, cumulative
+} HoloShard;
+
+extern struct HolographicSystem holo_system;
+extern struct Entity entity_pool[MAX_ENTITIES];
+extern uint32_t active_entity_count;
+extern uint32_t holo_dimensions;
+// Spawning stops at this many entities (at most MAX_ENTITIES); runtime tunable
+extern uint32_t holo_population_limit;
+// Postpones GC compaction while set (the kernel's deadline watchdog sheds
+// load this way); marked entities stay in the pool until a later generation
+extern uint8_t holo_defer_gc;
+extern HoloShard holo_shards[HOLO_MAX_SHARDS];
+extern uint32_t holo_shard_count;
+// Runtime tunable; 0 freezes the shard boundaries
+extern uint32_t holo_balance_interval;
+// Dormant generations without an interaction before an entity's vectors
+// move to the cold store; runtime tunable, 0 = never. Freezing is on by
+// default only in builds with fewer resident slots than entities.
+#if HOLO_RESIDENT_ENTITIES < MAX_ENTITIES
+#define HOLO_COLD_IDLE_GENERATIONS  32
+#else
+#define HOLO_COLD_IDLE_GENERATIONS  0
+#endif
+extern uint32_t holo_cold_idle_generations;
+// Paged builds: holographic_memory_store_bytes() of storage for the
+// memory-pool vectors, set before initialize_holographic_memory. Binding
+// never touches it, and a fresh pool expects it to read as zero.
+extern holo_scalar_t* holo_memory_store;
+
+// Cycles per encode/retrieve call; the caller initializes and prints them
+extern HdrHistogram encode_latency;
+extern HdrHistogram retrieve_latency;
+
+// Simulation core (holographic.c)
+
+uint32_t hash_data(const void* input, uint32_t size);
+// Continues a hash_data over the next `size` bytes, for data hashed in pieces
+#define HASH_DATA_SEED 2166136261U
+uint32_t hash_data_update(uint32_t hash, const void* input, uint32_t size);
+float dot_product(const float* a, const float* b, uint32_t dimensions);
+float cosine_similarity(const float* a, const float* b, uint32_t dimensions);
+
+// Q1.15 kernels: dot product in Q11.20, cosine in Q8.24. Identical results
+// from the SSE2 (pmaddwd) and scalar paths; SSE2 is used when the CPU and OS
+// allow it. Available in both builds so the two can be benchmarked.
+int32_t dot_product_q15(const int16_t* a, const int16_t* b, uint32_t dimensions);
+int32_t cosine_similarity_q15(const int16_t* a, const int16_t* b, uint32_t dimensions);
+
+// Cosine similarity of two vectors in the build's representation
+holo_alignment_t holographic_alignment(const HolographicVector* a, const HolographicVector* b);
+
+static inline float holo_alignment_to_float(holo_alignment_t alignment) {
+#if HOLOGRAPHIC_FIXED_POINT
+    return (float)alignment / HOLO_Q24_ONE;
+#else
+    return alignment;
+#endif
+}
+// Returns 0, or -1 when the count is not a multiple of
+// HOLOGRAPHIC_DIMENSION_ALIGN in [HOLOGRAPHIC_DIMENSION_ALIGN,
+// HOLOGRAPHIC_MAX_DIMENSIONS]. Takes effect at the next
+// initialize_holographic_memory, which lays out the slab.
+int holographic_set_dimensions(uint32_t dimensions);
+
+// Core-owned temporaries bound to the slab. Index 0 is used inside the core;
+// callers may use the others between core calls.
+#define HOLOGRAPHIC_SCRATCH_VECTORS 4
+#define HOLOGRAPHIC_TOP_K_MAX       16
+HolographicVector* holographic_scratch_vector(uint32_t index);
+
+void create_holographic_vector(HolographicVector* vector, const void* input, uint32_t size);
+void holographic_vector_copy(HolographicVector* dst, const HolographicVector* src);
+void encode_holographic_memory(HolographicVector* input, HolographicVector* output);
+HolographicVector* retrieve_holographic_memory(uint32_t hash);
+
+// Scans the valid memory entries and fills `indices` (pool positions) and
+// `scores` with the up to k (at most HOLOGRAPHIC_TOP_K_MAX) input patterns
+// best aligned with the query, best first. Returns how many were filled.
+uint32_t holographic_top_k(const HolographicVector* query, uint32_t k,
+                           uint32_t* indices, holo_alignment_t* scores);
+void initialize_holographic_memory();
+void load_initial_genome_vocabulary();
+void initialize_emergent_entities();
+struct Entity* spawn_entity();
+const char* entity_domain_name(const struct Entity* entity);
+void update_entities();
+
+// Splits the pool evenly into `count` shards (clamped to 1..HOLO_MAX_SHARDS)
+// owned by nodes[0..count-1], and clears their counters
+void holographic_partition_shards(uint32_t count, const uint32_t* nodes);
+
+// Bytes of state owned by the core (pools, update buffers, used slab)
+uint32_t holographic_footprint_bytes();
+
+// Slab bytes in use at the current dimensionality, and a hash over the
+// entity pool plus every entity's vector data (for replay verification)
+holo_scalar_t* holographic_slab_base();
+uint32_t holographic_slab_bytes();
+// Bytes of vector data the memory pool holds at the current dimensionality
+uint32_t holographic_memory_store_bytes();
+uint32_t holographic_entity_state_hash();
+// Rebuilds the slab's free entity storage and the cold store's block map
+// from a restored entity pool; returns 0, or -1 when they do not fit
+int holographic_storage_rebuild();
+
+// VGA presentation and periodic summaries (holographic_kernel.c)
+void render_entities_to_vga();
+void print_stats_summary(uint32_t generation);
+
+#endif
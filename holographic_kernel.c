@@ -1,100 +1,33 @@
 // holographic_kernel.c
 
-typedef unsigned char   uint8_t;
-typedef unsigned short  uint16_t;
-typedef unsigned int    uint32_t;
-typedef unsigned int    size_t; // Define size_t
-
-#ifndef NULL
-#define NULL ((void *)0)
-#endif
-
-// Enhanced Holographic Memory Configuration
-#define HOLOGRAPHIC_DIMENSIONS 512
-#define HOLOGRAPHIC_MEMORY_BASE 0xA0000
-#define HOLOGRAPHIC_MEMORY_SIZE 0x10000
-#define MAX_MEMORY_ENTRIES 128
-#define MAX_ENTITIES 32
-#define INITIAL_ENTITIES 3
-#define MAX_ENTITY_DOMAINS 8
-
-// Video Memory
-#define VIDEO_MEMORY 0xb8000
-
-// --- Modified Structures ---
-typedef struct {
-    uint32_t task_id;
-    uint32_t data[4];
-    uint8_t valid;
-} Task;
-
-typedef struct {
-    float data[HOLOGRAPHIC_DIMENSIONS];
-    uint32_t hash_signature;
-    uint16_t active_dimensions;
-    uint8_t valid;
-} HolographicVector;
-
-typedef struct {
-    HolographicVector input_pattern;
-    HolographicVector output_pattern;
-    uint32_t timestamp;
-    uint8_t valid;
-} MemoryEntry;
-
-// --- EMERGENCE: Enhanced Entity Structure for True Emergence ---
-// Adds task vectors, fitness, mutation flags, and GC markers
-struct Entity {
-    uint32_t id;
-    HolographicVector state;
-    HolographicVector* genome;
-    uint32_t age;
-    uint32_t interaction_count;
-    uint8_t is_active;
-    float specialization_scores[MAX_ENTITY_DOMAINS];
-    float resource_allocation;
-    float confidence;
-    char domain_name[32];
-
-    // --- EMERGENCE: Task & Path Assignment ---
-    HolographicVector task_vector;  // Assigned task encoded as vector
-    uint32_t path_id;               // Logical path ID (e.g., 0xA1 = network path)
-    float task_alignment;           // Cosine similarity between state and task
-
-    // --- EMERGENCE: Evolution & Fitness ---
-    uint32_t fitness_score;         // Accumulated performance metric
-    uint32_t spawn_count;           // Number of children spawned
-    uint8_t marked_for_gc;          // Garbage collection flag
-    uint8_t is_mutant;              // Mutation flag for debugging
-};
-
-struct HardwareInfo {
-    char cpu_vendor[13];
-    uint32_t cpu_features;
-    uint32_t memory_kb;
-    int device_count;
-};
-
-struct HolographicSystem {
-    MemoryEntry memory_pool[MAX_MEMORY_ENTRIES];
-    uint32_t memory_count;
-    uint32_t global_timestamp;
-} holo_system;
-
-struct Entity entity_pool[MAX_ENTITIES];
-uint32_t active_entity_count = 0;
-
-// --- EMERGENCE: Fast Inverse Square Root for Vector Math ---
-// Needed for cosine similarity in task alignment
-float sqrtf(float x) {
-    if (x <= 0.0f) return 0.0f;
-    float x_half = 0.5f * x;
-    int i = *(int*)&x;
-    i = 0x5f3759df - (i >> 1);
-    x = *(float*)&i;
-    x = x * (1.5f - x_half * x * x);
-    return 1.0f / x;
-}
+#include "kernel.h"
+#include "holographic.h"
+#include "idt.h"
+#include "timer.h"
+#include "profiler.h"
+#include "phase.h"
+#include "pmu.h"
+#include "hdr_histogram.h"
+#include "bench.h"
+#include "virtio_blk.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include "replay.h"
+#include "fw_cfg.h"
+#include "vecmath.h"
+#include "console.h"
+#include "watchdog.h"
+#include "prefetch.h"
+#include "numa.h"
+#include "logq.h"
+#include "paging.h"
+#include "pager.h"
+#include "coldstore.h"
+#include "genome.h"
+
+// Tail latency, in TSC cycles, reported with every stats summary
+static HdrHistogram generation_latency;
+static HdrHistogram render_latency;
 
 uint32_t check_protected_mode() {
     uint32_t cr0;
@@ -119,30 +52,55 @@ char *strncpy(char *dest, const char *src, size_t n) {
     return dest;
 }
 
+// Minimal memcpy implementation
+void *memcpy(void *dest, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dest;
+    const uint8_t *s = (const uint8_t *)src;
+    while (n--)
+        *d++ = *s++;
+    return dest;
+}
+
+// Minimal memset implementation
+void *memset(void *dest, int value, size_t n) {
+    uint8_t *d = (uint8_t *)dest;
+    while (n--)
+        *d++ = (uint8_t)value;
+    return dest;
+}
+
+#define STATS_SUMMARY_INTERVAL 32   // Generations between [STATS] summaries
+#define UPDATE_INTERVAL        (TIMER_HZ / 10)     // PIT ticks between generations (100 ms)
+
+// Main loop settings, adjustable at runtime from the serial console
+static uint32_t update_interval = UPDATE_INTERVAL;
+static uint32_t render_interval = 1;        // Generations between VGA redraws; 0 = off
+static uint32_t stats_interval = STATS_SUMMARY_INTERVAL;
+static uint32_t checkpoint_interval = CHECKPOINT_INTERVAL;
+static uint32_t profile_dump_interval = PROFILER_DUMP_INTERVAL;
+static uint32_t log_mask = LOG_ALL;
+
+// QEMU isa-debug-exit: writing v terminates QEMU with status (v << 1) | 1
+#define QEMU_DEBUG_EXIT_PORT    0xF4
+#define BENCH_EXIT_SUCCESS      0
+// Timestamp advance per generation in the benchmark workload: the step of
+// the old iteration-counted loop, kept so results stay comparable
+#define BENCH_TIMESTAMP_STEP    500001
+
+#define HOLO_DIMENSIONS_FW_CFG  "opt/holo/dimensions"
+
 //---Function Prototypes---
-void serial_init();
-void serial_write(char c);
-void serial_print(const char* str);
-void print_char(char c, uint8_t color);
-void print(const char* str);
-void print_hex(uint32_t value);
 void kmain();
-uint32_t hash_data(const void* input, uint32_t size);
-HolographicVector create_holographic_vector(const void* input, uint32_t size);
-void encode_holographic_memory(HolographicVector* input, HolographicVector* output);
-HolographicVector* retrieve_holographic_memory(uint32_t hash);
-void initialize_holographic_memory();
-void load_initial_genome_vocabulary();
-void initialize_emergent_entities();
-struct Entity* spawn_entity();
-void update_entities();
-void render_entities_to_vga();
+void register_tunables();
+void run_bench_workload(uint64_t boot_cycles);
+void select_dimensions();
 void probe_hardware();
 void set_memory_value(uint32_t address, uint8_t value);
 uint8_t get_memory_value(uint32_t address);
 
 //---Kernel starting point---
 void kmain() {
+    uint64_t boot_start = rdtsc();
     volatile char* video = (volatile char*)VIDEO_MEMORY;
     video[0] = 'K';
     video[1] = 0x0F;
@@ -157,379 +115,288 @@ void kmain() {
 
     serial_init();
     serial_print("DEBUG: Serial initialized, kernel reached!\n");
+
+    hdr_init(&generation_latency, "generation");
+    hdr_init(&render_latency, "render");
+    hdr_init(&encode_latency, "encode");
+    hdr_init(&retrieve_latency, "retrieve");
+
+    idt_init();
+    vecmath_init();
+    prefetch_init();
+    numa_init();
+    numa_assign_shards();
+    paging_init();
+    pmu_init();
+    timer_init(TIMER_HZ);
+    profiler_start();
+    console_init();
+    register_tunables();
+    interrupts_enable();
+    select_dimensions();
+    int disk = virtio_blk_init();
+    if (HOLOGRAPHIC_PAGED_MEMORY) {
+        if (!pager_init(holographic_memory_store_bytes())) {
+            serial_print("[BOOT] Paged memory pool unavailable, halting.\n");
+            __asm__ volatile("cli");
+            while (1) __asm__ volatile("hlt");
+        }
+        holo_memory_store = pager_window();
+    }
+#if BENCH_ON_BOOT
+    bench_run_all();
+#endif
     serial_print("Enhanced Holographic Kernel (Emergent Entities) Starting...\n");
     serial_print("Initializing high-dimensional memory system...\n");
 
     print("Enhanced Holographic Kernel (Emergent Entities) Starting...\n");
     print("Initializing high-dimensional memory system...\n");
 
-    initialize_holographic_memory();
-    load_initial_genome_vocabulary();
-    initialize_emergent_entities();
-
-    // --- EMERGENCE: Assign Initial Task Vectors ---
-    // Proof-of-concept: assign "network_io_path" to first entities
-    HolographicVector path_vector = create_holographic_vector("network_io_path", strlen("network_io_path") + 1);
-    for (int i = 0; i < active_entity_count && i < 2; i++) {
-        entity_pool[i].task_vector = path_vector;
-        entity_pool[i].path_id = 0xA1;
-        serial_print("[TASK] Assigned path 0xA1 to entity ");
-        print_hex(entity_pool[i].id);
+    uint32_t generation = 0;
+    int restored = 0;
+    // A replay must start from the same fresh pools the recording did
+    if (disk && CHECKPOINT_RESTORE_ON_BOOT && REPLAY_MODE != REPLAY_MODE_REPLAY) {
+        restored = checkpoint_restore(&generation);
+    }
+    replay_init(restored);
+    telemetry_init();
+
+    if (!restored) {
+        if (HOLOGRAPHIC_PAGED_MEMORY) pager_discard();
+        initialize_holographic_memory();
+        load_initial_genome_vocabulary();
+        initialize_emergent_entities();
+
+        // --- EMERGENCE: Assign Initial Task Vectors ---
+        // Proof-of-concept: assign "network_io_path" to first entities
+        HolographicVector* path_vector = holographic_scratch_vector(1);
+        create_holographic_vector(path_vector, "network_io_path", strlen("network_io_path") + 1);
+        for (int i = 0; i < active_entity_count && i < 2; i++) {
+            uint32_t arrival = replay_input(REPLAY_EVENT_TASK, ((uint32_t)i << 16) | 0xA1);
+            struct Entity* entity = &entity_pool[(arrival >> 16) % active_entity_count];
+            holographic_vector_copy(&entity->task_vector, path_vector);
+            entity->path_id = arrival & 0xFFFF;
+            serial_print("[TASK] Assigned path 0xA1 to entity ");
+            print_hex(entity->id);
+            serial_print("\n");
+        }
+    } else {
+        serial_print("[BOOT] Resumed from checkpoint at generation ");
+        serial_print_dec(generation);
         serial_print("\n");
     }
 
     print("Holographic Kernel with Emergent Entities Initialized!\n");
     print("System entering emergent entity loop...\n");
     serial_print("[BOOT] Kernel fully initialized. Emergence engine online.\n");
+    uint64_t boot_cycles = rdtsc() - boot_start;
+    serial_print("[BOOT] boot_cycles=");
+    serial_print_dec64(boot_cycles);
+    serial_print("\n");
+#if BENCH_GENERATIONS
+    run_bench_workload(boot_cycles);
+#endif
 
-    uint32_t last_update = 0;
-    uint32_t update_interval = 500000;
+    uint32_t last_update = timer_ticks();
 
-    while (1) {
-        if (holo_system.global_timestamp - last_update > update_interval) {
-            update_entities();
-            render_entities_to_vga();
-            last_update = holo_system.global_timestamp;
-        }
-        holo_system.global_timestamp++;
-        __asm__ volatile("hlt");
-    }
-}
+    holo_system.global_timestamp = replay_input(REPLAY_EVENT_SEED, holo_system.global_timestamp);
 
-//---Hash function (FNV-1a) ---
-uint32_t hash_data(const void* input, uint32_t size) {
-    const uint8_t* data = (const uint8_t*)input;
-    uint32_t hash = 2166136261U;
-    for (uint32_t i = 0; i < size; i++) {
-        hash ^= data[i];
-        hash *= 16777619U;
-    }
-    return hash;
-}
-
-//---Holographic Memory Functions ---
-HolographicVector create_holographic_vector(const void* input, uint32_t size) {
-    HolographicVector vector = {0};
-    vector.hash_signature = hash_data(input, size);
-    vector.valid = 1;
-    vector.active_dimensions = 0;
-
-    uint32_t seed = vector.hash_signature;
-    for (int i = 0; i < HOLOGRAPHIC_DIMENSIONS; i++) {
-        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
-        if ((seed % 10) == 0) {
-            vector.data[i] = ((float)((seed % 2000) - 1000)) / 1000.0f;
-            vector.active_dimensions++;
-        } else {
-            vector.data[i] = 0.0f;
+    while (1) {
+        // Replays run generations back to back, without rendering, logging,
+        // idling or console commands (a tunable changed mid-replay would
+        // diverge it)
+        int replaying = replay_is_replaying();
+        if (replaying && replay_finished()) {
+            __asm__ volatile("cli");
+            while (1) __asm__ volatile("hlt");
         }
-    }
-    return vector;
-}
-
-void encode_holographic_memory(HolographicVector* input, HolographicVector* output) {
-    if (holo_system.memory_count >= MAX_MEMORY_ENTRIES) {
-        for (int i = 0; i < MAX_MEMORY_ENTRIES - 1; i++) {
-            holo_system.memory_pool[i] = holo_system.memory_pool[i + 1];
+        if (!replaying) console_poll(generation);
+
+        // The idle branch halts until the next interrupt, at least one PIT
+        // tick, so generations are paced by the timer rather than by passes
+        if (replaying || timer_ticks() - last_update >= update_interval) {
+            replay_begin_generation(generation);
+            holo_system.global_timestamp = replay_input(REPLAY_EVENT_TIMESTAMP, holo_system.global_timestamp);
+
+            uint64_t generation_start = rdtsc();
+            watchdog_arm(generation);
+            // The generation logs into the queue; reports, console output
+            // and dumps between generations, which can outgrow the ring, write
+            // the UART directly once it is drained
+            logq_start();
+            int muted = console_is_muted();
+            console_set_muted(replaying || !(log_mask & LOG_CORE) || watchdog_shedding(WATCHDOG_SHED_LOGGING));
+            holo_defer_gc = !replaying && watchdog_shedding(WATCHDOG_SHED_GC);
+            update_entities();
+            console_set_muted(muted);
+            if (!replaying && render_interval && generation % render_interval == 0 &&
+                !watchdog_shedding(WATCHDOG_SHED_RENDER)) {
+                uint64_t render_start = rdtsc();
+                render_entities_to_vga();
+                hdr_record(&render_latency, rdtsc() - render_start);
+            }
+            uint64_t generation_cycles = rdtsc() - generation_start;
+            watchdog_disarm(generation_cycles);
+            hdr_record(&generation_latency, generation_cycles);
+            logq_stop();
+            telemetry_publish_generation(generation, generation_cycles);
+            phase_end_generation();
+            generation++;
+            replay_check_state(generation);
+
+            if (!replaying && checkpoint_interval && generation % checkpoint_interval == 0) {
+                console_set_muted(!(log_mask & LOG_CHECKPOINT));
+                checkpoint_save(generation);
+                replay_flush();
+                console_set_muted(muted);
+            }
+            if (!replaying && profile_dump_interval && generation % profile_dump_interval == 0 &&
+                (log_mask & LOG_PROFILER)) {
+                profiler_dump();
+            }
+            if (!replaying && stats_interval && generation % stats_interval == 0 && (log_mask & LOG_STATS)) {
+                print_stats_summary(generation);
+            }
+            last_update = timer_ticks();
         }
-        holo_system.memory_count = MAX_MEMORY_ENTRIES - 1;
-        serial_print("Warning: Holographic memory full, evicted oldest entry.\n");
-    }
-
-    MemoryEntry* entry = &holo_system.memory_pool[holo_system.memory_count];
-    entry->input_pattern = *input;
-    entry->output_pattern = *output;
-    entry->timestamp = holo_system.global_timestamp++;
-    entry->valid = 1;
-    holo_system.memory_count++;
-}
 
-HolographicVector* retrieve_holographic_memory(uint32_t hash) {
-    for (int i = holo_system.memory_count - 1; i >= 0; i--) {
-        if (holo_system.memory_pool[i].valid &&
-            holo_system.memory_pool[i].input_pattern.hash_signature == hash) {
-            return &holo_system.memory_pool[i].output_pattern;
+        if (!replaying) {
+            // Idle ticks stream out the checkpoint snapshot, if one is open
+            if (checkpoint_snapshot_active()) {
+                int muted = console_is_muted();
+                console_set_muted(!(log_mask & LOG_CHECKPOINT));
+                checkpoint_snapshot_step();
+                console_set_muted(muted);
+            }
+            holo_system.global_timestamp++;
+            __asm__ volatile("hlt");
         }
     }
-    return 0;
 }
 
-void initialize_holographic_memory() {
-    print("Setting up holographic memory pool...\n");
-    holo_system.memory_count = 0;
-    holo_system.global_timestamp = 0;
-    for (int i = 0; i < MAX_MEMORY_ENTRIES; i++) {
-        holo_system.memory_pool[i].valid = 0;
-    }
-    print("Holographic memory system online - ");
-    print_hex(HOLOGRAPHIC_DIMENSIONS);
-    print(" dimensions available\n");
+//---Stats summary---
+void print_stats_summary(uint32_t generation) {
+    serial_print("[STATS] generation=");
+    serial_print_dec(generation);
+    serial_print(" entities=");
+    serial_print_dec(active_entity_count);
+    serial_print(" memory_entries=");
+    serial_print_dec(holo_system.memory_count);
+    serial_print(" timestamp=");
+    serial_print_dec(holo_system.global_timestamp);
+    serial_print("\n");
+    phase_print_summary();
+    hdr_print(&generation_latency);
+    hdr_print(&render_latency);
+    hdr_print(&encode_latency);
+    hdr_print(&retrieve_latency);
+    watchdog_print_summary();
+    numa_print_summary();
+    if (HOLOGRAPHIC_PAGED_MEMORY) pager_print_summary();
+    cold_store_print_summary();
+    genome_print_summary();
 }
 
-void load_initial_genome_vocabulary() {
-    const char* vocab[] = {
-        "ACTION_PRODUCE", "ACTION_CONSUME", "ACTION_SHARE",
-        "ACTION_ACTIVATE", "ACTION_DEACTIVATE",
-        "TRAIT_GENERIC", "TRAIT_ACTIVE", "TRAIT_DORMANT",
-        "SENSOR_NEIGHBOR_ACTIVE", "SENSOR_MEMORY_MATCH",
-        "GENOME_SIMPLE_RULE_1"
-    };
-    int num_vocab = sizeof(vocab) / sizeof(vocab[0]);
-
-    serial_print("Loading initial genome vocabulary...\n");
-    for (int i = 0; i < num_vocab; i++) {
-        HolographicVector pattern = create_holographic_vector(vocab[i], strlen(vocab[i]) + 1);
-        encode_holographic_memory(&pattern, &pattern);
-        serial_print("  Loaded: ");
-        serial_print(vocab[i]);
-        serial_print("\n");
-    }
-    serial_print("Initial genome vocabulary loaded.\n");
+//---Console tunables---
+void register_tunables() {
+    console_register_tunable("update_interval", &update_interval, 0, 0xFFFFFFFF,
+                             "PIT ticks (1 ms) between generations");
+    console_register_tunable("render_interval", &render_interval, 0, 0xFFFF,
+                             "generations between VGA redraws, 0 = off");
+    console_register_tunable("stats_interval", &stats_interval, 0, 0xFFFF,
+                             "generations between [STATS] summaries, 0 = off");
+    console_register_tunable("checkpoint_interval", &checkpoint_interval, 0, 0xFFFF,
+                             "generations between checkpoints, 0 = off");
+    console_register_tunable("profile_dump_interval", &profile_dump_interval, 0, 0xFFFF,
+                             "generations between [PROF] dumps, 0 = off");
+    console_register_tunable("log_mask", &log_mask, 0, LOG_ALL,
+                             "1 core, 2 stats, 4 profiler, 8 checkpoint");
+    console_register_tunable("watchdog_budget_ms", &watchdog_budget_ms, 0, 60000,
+                             "generation deadline, 0 = watchdog off");
+    console_register_tunable("watchdog_shed_mask", &watchdog_shed_mask, 0, 7,
+                             "after an overrun: 1 skip render, 2 mute core, 4 defer GC");
+    // Stays pinned at 0 when prefetch_init found no SSE
+    console_register_tunable("prefetch_distance", &prefetch_distance, 0,
+                             prefetch_distance ? PREFETCH_DISTANCE_MAX : 0,
+                             "bytes the pool scans prefetch ahead, 0 = off");
+    console_register_tunable("balance_interval", &holo_balance_interval, 0, 0xFFFF,
+                             "generations between shard rebalancing, 0 = off");
+    console_register_tunable("population_limit", &holo_population_limit, 1, MAX_ENTITIES,
+                             "spawning stops at this many entities");
+    console_register_tunable("cold_after", &holo_cold_idle_generations, 0, 0xFFFF,
+                             "idle dormant generations before an entity is compressed, 0 = off");
 }
 
-void initialize_emergent_entities() {
-    serial_print("Initializing emergent entity pool...\n");
-
-    HolographicVector simple_genome_rule = create_holographic_vector("GENOME_SIMPLE_RULE_1", strlen("GENOME_SIMPLE_RULE_1") + 1);
-    HolographicVector* genome_ptr = retrieve_holographic_memory(simple_genome_rule.hash_signature);
-
-    if (!genome_ptr) {
-        serial_print("Error: Initial genome rule not found in memory!\n");
-        encode_holographic_memory(&simple_genome_rule, &simple_genome_rule);
-        genome_ptr = &simple_genome_rule;
-    }
-
-    HolographicVector trait_dormant = create_holographic_vector("TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
-
-    for (int i = 0; i < INITIAL_ENTITIES; i++) {
-        if (active_entity_count >= MAX_ENTITIES) {
-            serial_print("Error: Cannot initialize more entities, pool full.\n");
-            break;
-        }
-
-        struct Entity* entity = &entity_pool[active_entity_count];
-        entity->id = active_entity_count;
-        entity->age = 0;
-        entity->interaction_count = 0;
-        entity->is_active = 1;
-        entity->state = trait_dormant;
-        entity->genome = genome_ptr;
-
-        for (int j = 0; j < MAX_ENTITY_DOMAINS; j++) {
-            entity->specialization_scores[j] = 0.1f;
+//---Vector dimensionality---
+// Taken from fw_cfg "opt/holo/dimensions" when present (see HOLO_DIMENSIONS
+// in the Makefile), else the build default HOLOGRAPHIC_DIMENSIONS
+void select_dimensions() {
+    uint32_t dimensions;
+    if (fw_cfg_read_u32(HOLO_DIMENSIONS_FW_CFG, &dimensions)) {
+        if (holographic_set_dimensions(dimensions) != 0) {
+            serial_print("[BOOT] Ignoring invalid dimensions=");
+            serial_print_dec(dimensions);
+            serial_print("\n");
         }
-
-        entity->resource_allocation = 1.0f;
-        entity->confidence = 0.5f;
-        entity->fitness_score = 0;
-        entity->spawn_count = 0;
-        entity->marked_for_gc = 0;
-        entity->is_mutant = 0;
-        entity->task_alignment = 0.0f;
-
-        strncpy(entity->domain_name, "generic", 31);
-        entity->domain_name[31] = '\0';
-
-        active_entity_count++;
-        serial_print("  Initialized entity ID: ");
-        print_hex(entity->id);
-        serial_print("\n");
-    }
-
-    serial_print("Initialized ");
-    print_hex(active_entity_count);
-    serial_print(" emergent entities.\n");
-}
-
-struct Entity* spawn_entity() {
-    if (active_entity_count >= MAX_ENTITIES) {
-        serial_print("Cannot spawn: Entity pool full.\n");
-        return NULL;
-    }
-
-    struct Entity* new_entity = &entity_pool[active_entity_count];
-    new_entity->id = active_entity_count;
-    new_entity->age = 0;
-    new_entity->interaction_count = 0;
-    new_entity->is_active = 1;
-    new_entity->fitness_score = 0;
-    new_entity->spawn_count = 0;
-    new_entity->marked_for_gc = 0;
-    new_entity->is_mutant = 0;
-
-    HolographicVector simple_genome_rule = create_holographic_vector("GENOME_SIMPLE_RULE_1", strlen("GENOME_SIMPLE_RULE_1") + 1);
-    HolographicVector* genome_ptr = retrieve_holographic_memory(simple_genome_rule.hash_signature);
-
-    if (!genome_ptr) {
-        encode_holographic_memory(&simple_genome_rule, &simple_genome_rule);
-        genome_ptr = &simple_genome_rule;
     }
-
-    new_entity->state = create_holographic_vector("TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
-    new_entity->genome = genome_ptr;
-
-    for (int i = 0; i < MAX_ENTITY_DOMAINS; i++) {
-        new_entity->specialization_scores[i] = 0.1f;
-    }
-
-    new_entity->resource_allocation = 1.0f;
-    new_entity->confidence = 0.5f;
-    new_entity->task_alignment = 0.0f;
-
-    strncpy(new_entity->domain_name, "emergent", 31);
-    new_entity->domain_name[31] = '\0';
-
-    active_entity_count++;
-    serial_print("[SPAWN] SUCCESS: New entity ID ");
-    print_hex(new_entity->id);
-    serial_print(" initialized.\n");
-    return new_entity;
+    serial_print("[BOOT] dimensions=");
+    serial_print_dec(holo_dimensions);
+    serial_print("\n");
 }
 
-// --- EMERGENCE: Core Update Loop with CA Rules, Task Alignment, Mutation, GC ---
-void update_entities() {
-    uint8_t next_active[MAX_ENTITIES] = {0};
-    HolographicVector next_state[MAX_ENTITIES];
-    char next_domain[MAX_ENTITIES][32];
-    HolographicVector next_task_vector[MAX_ENTITIES];
-    uint32_t next_path_id[MAX_ENTITIES];
-    float next_task_alignment[MAX_ENTITIES];
-
-    uint32_t hash_trait_active = create_holographic_vector("TRAIT_ACTIVE", strlen("TRAIT_ACTIVE") + 1).hash_signature;
-    uint32_t hash_trait_dormant = create_holographic_vector("TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1).hash_signature;
-    uint32_t hash_action_spawn = create_holographic_vector("ACTION_SPAWN", strlen("ACTION_SPAWN") + 1).hash_signature;
-
-    serial_print("[GC] Starting entity update cycle...\n");
-
-    for (int i = 0; i < active_entity_count; i++) {
-        struct Entity* entity = &entity_pool[i];
-
-        next_active[i] = entity->is_active;
-        next_state[i] = entity->state;
-        strncpy(next_domain[i], entity->domain_name, 31);
-        next_domain[i][31] = '\0';
-        next_task_vector[i] = entity->task_vector;
-        next_path_id[i] = entity->path_id;
-        next_task_alignment[i] = entity->task_alignment;
-
-        entity->age++;
-
-        int neighbor_active = 0;
-        int prev_idx = (i == 0) ? (active_entity_count - 1) : (i - 1);
-        int next_idx = (i == active_entity_count - 1) ? 0 : (i + 1);
-
-        if (entity_pool[prev_idx].is_active) neighbor_active++;
-        if (entity_pool[next_idx].is_active) neighbor_active++;
-
-        // --- EMERGENCE: Cellular Automata Rule 1 - Activate if neighbor active ---
-        if (!entity->is_active && neighbor_active > 0) {
-            next_active[i] = 1;
-            next_state[i] = create_holographic_vector("TRAIT_ACTIVE", strlen("TRAIT_ACTIVE") + 1);
-            strncpy(next_domain[i], "reactor", 31);
-            next_domain[i][31] = '\0';
-            entity->interaction_count++;
-            serial_print("[SPAWN] Entity ");
-            print_hex(entity->id);
-            serial_print(" activated by neighbor.\n");
-        }
-        // --- EMERGENCE: Cellular Automata Rule 2 - Sleep if no neighbors ---
-        else if (entity->is_active && neighbor_active == 0) {
-            next_active[i] = 0;
-            next_state[i] = create_holographic_vector("TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
-            strncpy(next_domain[i], "sleeper", 31);
-            next_domain[i][31] = '\0';
-            entity->interaction_count++;
-            serial_print("[SLEEP] Entity ");
-            print_hex(entity->id);
-            serial_print(" going dormant (no neighbors).\n");
-        }
-        // --- EMERGENCE: Cellular Automata Rule 3 - Spawn if 2+ neighbors ---
-        else if (entity->is_active && neighbor_active >= 2 && active_entity_count < MAX_ENTITIES - 1) {
-            struct Entity* child = spawn_entity();
-            if (child) {
-                child->genome = entity->genome;
-                child->is_mutant = 1;
-
-                // --- EMERGENCE: Simple Mutation - Flip one random dimension ---
-                child->state = entity->state;
-                if (HOLOGRAPHIC_DIMENSIONS > 0) {
-                    int rand_dim = holo_system.global_timestamp % HOLOGRAPHIC_DIMENSIONS;
-                    child->state.data[rand_dim] = -child->state.data[rand_dim];
-                }
-                child->task_vector = entity->task_vector;
-                child->path_id = entity->path_id;
-                child->task_alignment = entity->task_alignment;
-
-                serial_print("[MUTATE] Spawned mutant child ID: ");
-                print_hex(child->id);
-                serial_print(" from parent ");
-                print_hex(entity->id);
-                serial_print("\n");
-                entity->spawn_count++;
-                entity->fitness_score += 10;
-            }
-        }
-
-        // --- EMERGENCE: Task Alignment via Cosine Similarity ---
-        if (entity->task_vector.valid) {
-            float dot = 0.0f;
-            float mag1 = 0.0f, mag2 = 0.0f;
-            for (int d = 0; d < HOLOGRAPHIC_DIMENSIONS; d++) {
-                dot += entity->state.data[d] * entity->task_vector.data[d];
-                mag1 += entity->state.data[d] * entity->state.data[d];
-                mag2 += entity->task_vector.data[d] * entity->task_vector.data[d];
-            }
-            mag1 = (mag1 > 0) ? sqrtf(mag1) : 1.0f;
-            mag2 = (mag2 > 0) ? sqrtf(mag2) : 1.0f;
-            next_task_alignment[i] = (mag1 * mag2 > 0) ? (dot / (mag1 * mag2)) : 0.0f;
-
-            if (next_task_alignment[i] > 0.7f) {
-                entity->fitness_score += 5;
-                serial_print("[FIT] Entity ");
-                print_hex(entity->id);
-                serial_print(" alignment high. Fitness +5.\n");
-            }
-        }
-
-        // --- EMERGENCE: Mark Low-Fitness/Old Entities for GC ---
-        if (entity->age > 1000 && entity->fitness_score < 50) {
-            entity->marked_for_gc = 1;
-            serial_print("[GC] Entity ");
-            print_hex(entity->id);
-            serial_print(" marked for garbage collection (low fitness).\n");
-        }
-    }
-
-    // --- EMERGENCE: Apply State Changes ---
-    for (int i = 0; i < active_entity_count; i++) {
-        entity_pool[i].is_active = next_active[i];
-        entity_pool[i].state = next_state[i];
-        strncpy(entity_pool[i].domain_name, next_domain[i], 31);
-        entity_pool[i].domain_name[31] = '\0';
-        entity_pool[i].task_vector = next_task_vector[i];
-        entity_pool[i].path_id = next_path_id[i];
-        entity_pool[i].task_alignment = next_task_alignment[i];
+#if BENCH_GENERATIONS
+//---Benchmark workload---
+// Runs BENCH_GENERATIONS generations back to back with logging muted, prints
+// [RESULT] lines plus the stats summary, and exits QEMU. Wall time comes
+// from PIT ticks; the TSC rate is calibrated against them over the run.
+void run_bench_workload(uint64_t boot_cycles) {
+    console_set_muted(1);
+    uint32_t start_ticks = timer_ticks();
+    uint64_t start_cycles = rdtsc();
+    for (uint32_t generation = 0; generation < BENCH_GENERATIONS; generation++) {
+        holo_system.global_timestamp += BENCH_TIMESTAMP_STEP;
+        uint64_t generation_start = rdtsc();
+        update_entities();
+        hdr_record(&generation_latency, rdtsc() - generation_start);
+        phase_end_generation();
     }
-
-    // --- EMERGENCE: Garbage Collection Phase ---
-    int write_index = 0;
-    for (int i = 0; i < active_entity_count; i++) {
-        if (!entity_pool[i].marked_for_gc) {
-            if (write_index != i) {
-                entity_pool[write_index] = entity_pool[i];
-            }
-            write_index++;
-        } else {
-            serial_print("[GC] Entity ");
-            print_hex(entity_pool[i].id);
-            serial_print(" collected.\n");
-        }
-    }
-    active_entity_count = write_index;
-    serial_print("[GC] Update cycle completed. Active entities: ");
-    print_hex(active_entity_count);
+    uint64_t cycles = rdtsc() - start_cycles;
+    uint32_t ticks = timer_ticks() - start_ticks;
+    console_set_muted(0);
+
+    if (ticks == 0) ticks = 1;
+    uint64_t tsc_hz = div64_u32(cycles * timer_hz(), ticks);
+    uint32_t tsc_khz = (uint32_t)div64_u32(tsc_hz, 1000);
+
+    serial_print("[RESULT] boot_cycles=");
+    serial_print_dec64(boot_cycles);
+    serial_print(" boot_us=");
+    serial_print_dec64(tsc_khz ? div64_u32(boot_cycles * 1000, tsc_khz) : 0);
+    serial_print("\n");
+    serial_print("[RESULT] generations=");
+    serial_print_dec(BENCH_GENERATIONS);
+    serial_print(" population=");
+    serial_print_dec(INITIAL_ENTITIES);
+    serial_print(" final_entities=");
+    serial_print_dec(active_entity_count);
+    serial_print(" elapsed_ms=");
+    serial_print_dec((uint32_t)div64_u32((uint64_t)ticks * 1000, timer_hz()));
+    serial_print(" cycles=");
+    serial_print_dec64(cycles);
+    serial_print(" tsc_hz=");
+    serial_print_dec64(tsc_hz);
+    serial_print(" gens_per_sec=");
+    serial_print_dec64(div64_u32((uint64_t)BENCH_GENERATIONS * timer_hz(), ticks));
     serial_print("\n");
+    print_stats_summary(BENCH_GENERATIONS);
+    serial_print("[RESULT] END\n");
+
+    outb(QEMU_DEBUG_EXIT_PORT, BENCH_EXIT_SUCCESS);
+    // Not running under QEMU with isa-debug-exit: stop here
+    __asm__ volatile("cli");
+    while (1) __asm__ volatile("hlt");
 }
+#endif
 
 void render_entities_to_vga() {
     volatile char* video = (volatile char*)VIDEO_MEMORY;
@@ -537,6 +404,7 @@ void render_entities_to_vga() {
     int start_col = 0;
     int max_lines = 15;
 
+    phase_enter(PHASE_RENDER);
     for (int y = 0; y < max_lines && (start_line + y) < 25; y++) {
         for (int x = 0; x < 80; x++) {
             int screen_pos = ((start_line + y) * 80 + x) * 2;
@@ -549,6 +417,10 @@ void render_entities_to_vga() {
         struct Entity* entity = &entity_pool[i];
         int screen_y = start_line + i;
         if (screen_y >= 25) break;
+        // VGA writes are uncached and slow; the next record arrives meanwhile
+        if (prefetch_distance && i + 1 < active_entity_count) {
+            prefetch_range(&entity_pool[i + 1], sizeof(struct Entity), PREFETCH_T0);
+        }
 
         int col = start_col;
         int screen_pos = (screen_y * 80 + col) * 2;
@@ -561,11 +433,12 @@ void render_entities_to_vga() {
         video[screen_pos] = entity->is_active ? 'A' : 'D'; screen_pos += 2;
         video[screen_pos] = ' '; screen_pos += 2;
 
-        int domain_len = strlen(entity->domain_name);
+        const char* domain_name = entity_domain_name(entity);
+        int domain_len = strlen(domain_name);
         for (int j = 0; j < 6 && j < domain_len; j++) {
-            video[screen_pos] = entity->domain_name[j]; screen_pos += 2;
+            video[screen_pos] = domain_name[j]; screen_pos += 2;
         }
-        for (int j = strlen(entity->domain_name); j < 6; j++) {
+        for (int j = domain_len; j < 6; j++) {
             video[screen_pos] = ' '; screen_pos += 2;
         }
         video[screen_pos] = ' '; screen_pos += 2;
@@ -590,6 +463,7 @@ void render_entities_to_vga() {
         video[screen_pos] = '0' + fit_int; screen_pos += 2;
         video[screen_pos] = ' '; screen_pos += 2;
     }
+    phase_exit();
 }
 
 void probe_hardware() {
@@ -624,7 +498,18 @@ void print_char(char c, uint8_t color) {
     }
 }
 
+static int console_muted = 0;
+
+void console_set_muted(int muted) {
+    console_muted = muted;
+}
+
+int console_is_muted() {
+    return console_muted;
+}
+
 void print(const char* str) {
+    if (console_muted) return;
     while (*str != 0) {
         print_char(*str, 0x0f);
         str++;
@@ -642,14 +527,39 @@ void print_hex(uint32_t value) {
     print(buffer);
 }
 
-static inline uint8_t inb(uint16_t port) {
-    uint8_t result;
-    __asm__ volatile("inb %1, %0" : "=a"(result) : "Nd"(port));
-    return result;
+void serial_print_hex(uint32_t value) {
+    char hex_digits[] = "0123456789ABCDEF";
+    char buffer[11];
+    buffer[0] = '0';
+    buffer[1] = 'x';
+    for (int i = 7; i >= 0; i--) {
+        buffer[9-i] = hex_digits[(value >> (i*4)) & 0xF];
+    }
+    buffer[10] = '\0';
+    serial_print(buffer);
 }
 
-static inline void outb(uint16_t port, uint8_t data) {
-    __asm__ volatile("outb %0, %1" : : "a"(data), "Nd"(port));
+void serial_print_dec(uint32_t value) {
+    char buffer[11];
+    int pos = 10;
+    buffer[pos] = '\0';
+    do {
+        buffer[--pos] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+    serial_print(&buffer[pos]);
+}
+
+void serial_print_dec64(uint64_t value) {
+    char buffer[21];
+    int pos = 20;
+    buffer[pos] = '\0';
+    do {
+        uint64_t quotient = div64_u32(value, 10);
+        buffer[--pos] = '0' + (uint32_t)(value - quotient * 10);
+        value = quotient;
+    } while (value != 0);
+    serial_print(&buffer[pos]);
 }
 
 void serial_init() {
@@ -668,6 +578,11 @@ void serial_write(char c) {
 }
 
 void serial_print(const char* str) {
+    if (console_muted) return;
+    if (logq_running()) {
+        logq_write(str);
+        return;
+    }
     while (*str != 0) {
         serial_write(*str);
         str++;
@@ -0,0 +1,133 @@
+// idt.c
+
+#include "kernel.h"
+#include "idt.h"
+#include "logq.h"
+
+#define PIC1_COMMAND 0x20
+#define PIC1_DATA    0x21
+#define PIC2_COMMAND 0xA0
+#define PIC2_DATA    0xA1
+#define PIC_EOI      0x20
+
+#define KERNEL_CODE_SELECTOR 0x08   // gdt_code in boot.asm
+#define IDT_INTERRUPT_GATE   0x8E   // Present, ring 0, 32-bit interrupt gate
+
+typedef struct {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t zero;
+    uint8_t type_attr;
+    uint16_t offset_high;
+} __attribute__((packed)) IdtEntry;
+
+typedef struct {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed)) IdtDescriptor;
+
+extern uint32_t isr_stub_table[IDT_STUB_COUNT];
+
+static IdtEntry idt[256] __attribute__((aligned(8)));
+static interrupt_handler_t handlers[IDT_STUB_COUNT];
+
+static const char* exception_names[32] = {
+    "Divide Error", "Debug", "NMI", "Breakpoint", "Overflow", "Bound Range",
+    "Invalid Opcode", "Device Not Available", "Double Fault", "Coprocessor Overrun",
+    "Invalid TSS", "Segment Not Present", "Stack Fault", "General Protection",
+    "Page Fault", "Reserved", "x87 FPU Error", "Alignment Check", "Machine Check",
+    "SIMD Exception", "Virtualization", "Control Protection", "Reserved", "Reserved",
+    "Reserved", "Reserved", "Reserved", "Reserved", "Hypervisor Injection",
+    "VMM Communication", "Security Exception", "Reserved"
+};
+
+static void idt_set_gate(uint8_t vector, uint32_t handler) {
+    idt[vector].offset_low = handler & 0xFFFF;
+    idt[vector].selector = KERNEL_CODE_SELECTOR;
+    idt[vector].zero = 0;
+    idt[vector].type_attr = IDT_INTERRUPT_GATE;
+    idt[vector].offset_high = handler >> 16;
+}
+
+// Master at 0x20, slave at 0x28, all lines masked until a handler claims one
+static void pic_remap() {
+    outb(PIC1_COMMAND, 0x11);   // ICW1: init, expect ICW4
+    outb(PIC2_COMMAND, 0x11);
+    outb(PIC1_DATA, IRQ_BASE_VECTOR);
+    outb(PIC2_DATA, IRQ_BASE_VECTOR + 8);
+    outb(PIC1_DATA, 0x04);      // ICW3: slave on IRQ2
+    outb(PIC2_DATA, 0x02);
+    outb(PIC1_DATA, 0x01);      // ICW4: 8086 mode
+    outb(PIC2_DATA, 0x01);
+    outb(PIC1_DATA, 0xFB);      // Keep the cascade line open
+    outb(PIC2_DATA, 0xFF);
+}
+
+void irq_mask(uint8_t irq) {
+    uint16_t port = (irq < 8) ? PIC1_DATA : PIC2_DATA;
+    outb(port, inb(port) | (1 << (irq & 7)));
+}
+
+void irq_unmask(uint8_t irq) {
+    uint16_t port = (irq < 8) ? PIC1_DATA : PIC2_DATA;
+    outb(port, inb(port) & ~(1 << (irq & 7)));
+}
+
+void interrupt_register(uint8_t vector, interrupt_handler_t handler) {
+    if (vector < IDT_STUB_COUNT) handlers[vector] = handler;
+}
+
+void irq_register(uint8_t irq, interrupt_handler_t handler) {
+    interrupt_register(IRQ_BASE_VECTOR + irq, handler);
+    irq_unmask(irq);
+}
+
+void exception_panic(InterruptFrame* frame) {
+    console_set_muted(0);
+    logq_stop();
+    serial_print("\n[PANIC] ");
+    serial_print(exception_names[frame->vector]);
+    serial_print(" (vector ");
+    serial_print_dec(frame->vector);
+    serial_print(") at EIP ");
+    serial_print_hex(frame->eip);
+    serial_print(", error ");
+    serial_print_hex(frame->error_code);
+    if (frame->vector == EXCEPTION_PAGE_FAULT) {
+        uint32_t cr2;
+        __asm__ volatile("mov %%cr2, %0" : "=r"(cr2));
+        serial_print(", CR2 ");
+        serial_print_hex(cr2);
+    }
+    serial_print("\n");
+    __asm__ volatile("cli");
+    while (1) __asm__ volatile("hlt");
+}
+
+void interrupt_dispatch(InterruptFrame* frame) {
+    uint32_t vector = frame->vector;
+
+    if (vector < IDT_STUB_COUNT && handlers[vector]) {
+        handlers[vector](frame);
+    } else if (vector < IRQ_BASE_VECTOR) {
+        exception_panic(frame);
+    }
+
+    if (vector >= IRQ_BASE_VECTOR && vector < IRQ_BASE_VECTOR + 16) {
+        if (vector >= IRQ_BASE_VECTOR + 8) outb(PIC2_COMMAND, PIC_EOI);
+        outb(PIC1_COMMAND, PIC_EOI);
+    }
+}
+
+void idt_init() {
+    pic_remap();
+    for (int vector = 0; vector < IDT_STUB_COUNT; vector++) {
+        idt_set_gate(vector, isr_stub_table[vector]);
+    }
+
+    IdtDescriptor descriptor;
+    descriptor.limit = sizeof(idt) - 1;
+    descriptor.base = (uint32_t)idt;
+    __asm__ volatile("lidt %0" : : "m"(descriptor));
+    serial_print("[IDT] Exceptions and PIC IRQs installed.\n");
+}
@@ -0,0 +1,45 @@
+// idt.h
+// Interrupt descriptor table, 8259 PIC and handler registration.
+
+#ifndef IDT_H
+#define IDT_H
+
+#include "kernel.h"
+
+#define IRQ_BASE_VECTOR 32          // PIC remapped above the CPU exceptions
+#define IDT_STUB_COUNT  48
+
+#define IRQ_TIMER   0
+#define IRQ_COM1    4
+
+#define EXCEPTION_PAGE_FAULT 14
+
+// Stack layout built by isr_common in interrupts.asm (pushad + stub pushes +
+// CPU frame). Ring 0 only, so the CPU pushes no ESP/SS.
+typedef struct {
+    uint32_t edi, esi, ebp, esp_unused, ebx, edx, ecx, eax;
+    uint32_t vector;
+    uint32_t error_code;
+    uint32_t eip;
+    uint32_t cs;
+    uint32_t eflags;
+} InterruptFrame;
+
+typedef void (*interrupt_handler_t)(InterruptFrame* frame);
+
+// Stack pointer of the interrupted code (no privilege change, so it sits
+// right above the CPU-pushed frame).
+static inline uint32_t interrupt_frame_esp(const InterruptFrame* frame) {
+    return (uint32_t)&frame->eflags + 4;
+}
+
+void idt_init();
+void interrupt_register(uint8_t vector, interrupt_handler_t handler);
+void irq_register(uint8_t irq, interrupt_handler_t handler);   // Also unmasks the line
+void irq_mask(uint8_t irq);
+void irq_unmask(uint8_t irq);
+
+// Reports the exception and halts; for handlers that decline a fault
+void exception_panic(InterruptFrame* frame);
+
+#endif
@@ -0,0 +1,52 @@
+; interrupts.asm
+; Entry stubs for CPU exceptions (0-31) and remapped PIC IRQs (32-47).
+; Every stub leaves the same frame on the stack (see InterruptFrame in idt.h)
+; and funnels into interrupt_dispatch.
+[bits 32]
+
+extern interrupt_dispatch
+
+global isr_stub_table
+
+section .text
+
+%macro ISR_NOERR 1
+isr_stub_%1:
+    push dword 0            ; Dummy error code
+    push dword %1
+    jmp isr_common
+%endmacro
+
+%macro ISR_ERR 1
+isr_stub_%1:
+    push dword %1           ; CPU already pushed the error code
+    jmp isr_common
+%endmacro
+
+isr_common:
+    pushad
+    cld
+    push esp                ; InterruptFrame*
+    call interrupt_dispatch
+    add esp, 4
+    popad
+    add esp, 8              ; Vector and error code
+    iretd
+
+%assign vec 0
+%rep 48
+%if vec == 8 || (vec >= 10 && vec <= 14) || vec == 17 || vec == 21 || vec == 29 || vec == 30
+    ISR_ERR %[vec]
+%else
+    ISR_NOERR %[vec]
+%endif
+%assign vec vec + 1
+%endrep
+
+section .data
+isr_stub_table:
+%assign vec 0
+%rep 48
+    dd isr_stub_%[vec]
+%assign vec vec + 1
+%endrep
@@ -0,0 +1,33 @@
+// ivshmem.c
+
+#include "kernel.h"
+#include "pci.h"
+#include "ivshmem.h"
+
+int ivshmem_init(uint32_t* base, uint32_t* size) {
+    PciDevice dev;
+
+    if (!pci_find_device(IVSHMEM_VENDOR_ID, IVSHMEM_DEVICE_ID, &dev)) {
+        serial_print("[IVSHMEM] No ivshmem-plain device found.\n");
+        return 0;
+    }
+
+    uint8_t is_io = 0;
+    uint32_t bar = pci_bar_address(&dev, IVSHMEM_SHARED_BAR, &is_io);
+    uint32_t bar_size = pci_bar_size(&dev, IVSHMEM_SHARED_BAR);
+    if (is_io || bar == 0 || bar_size == 0) {
+        serial_print("[IVSHMEM] Shared memory BAR is not reachable.\n");
+        return 0;
+    }
+
+    pci_enable(&dev, PCI_COMMAND_MEMORY);
+
+    *base = bar;
+    *size = bar_size;
+    serial_print("[IVSHMEM] Shared memory at ");
+    serial_print_hex(bar);
+    serial_print(", ");
+    serial_print_dec(bar_size >> 10);
+    serial_print(" KB\n");
+    return 1;
+}
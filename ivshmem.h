@@ -0,0 +1,17 @@
+// ivshmem.h
+// QEMU ivshmem-plain: a PCI device whose BAR2 is host-shared memory.
+
+#ifndef IVSHMEM_H
+#define IVSHMEM_H
+
+#include "kernel.h"
+
+#define IVSHMEM_VENDOR_ID   0x1AF4
+#define IVSHMEM_DEVICE_ID   0x1110
+#define IVSHMEM_SHARED_BAR  2
+
+// Returns 1 and the shared window when the device is present and its BAR
+// is reachable below 4 GB, 0 otherwise.
+int ivshmem_init(uint32_t* base, uint32_t* size);
+
+#endif
@@ -0,0 +1,220 @@
+// kernel.h
+// Freestanding basics shared by every kernel translation unit.
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+typedef unsigned char       uint8_t;
+typedef unsigned short      uint16_t;
+typedef unsigned int        uint32_t;
+typedef unsigned long long  uint64_t;
+typedef signed char         int8_t;
+typedef short               int16_t;
+typedef int                 int32_t;
+typedef long long           int64_t;
+typedef unsigned int        size_t; // Define size_t
+
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+// Coherence granule on every x86 target we run on. Per-CPU state and data
+// written by different agents (CPU vs. interrupt, producer vs. consumer)
+// is aligned to it so unrelated writers never share a line.
+#define CACHE_LINE_SIZE 64
+
+// Video Memory
+#define VIDEO_MEMORY 0xb8000
+
+// Stack set up by boot.asm/kernel_entry.asm; grows down from here
+#define KERNEL_STACK_TOP 0x90000
+
+// Only the bootstrap processor runs today; per-core state is still sized
+// and indexed by CPU so it stays correct once APs are started.
+#define MAX_CPUS 1
+
+static inline uint32_t cpu_index(void) {
+    return 0;
+}
+
+// --- Port I/O ---
+static inline uint8_t inb(uint16_t port) {
+    uint8_t result;
+    __asm__ volatile("inb %1, %0" : "=a"(result) : "Nd"(port));
+    return result;
+}
+
+static inline void outb(uint16_t port, uint8_t data) {
+    __asm__ volatile("outb %0, %1" : : "a"(data), "Nd"(port));
+}
+
+static inline uint16_t inw(uint16_t port) {
+    uint16_t result;
+    __asm__ volatile("inw %1, %0" : "=a"(result) : "Nd"(port));
+    return result;
+}
+
+static inline void outw(uint16_t port, uint16_t data) {
+    __asm__ volatile("outw %0, %1" : : "a"(data), "Nd"(port));
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t result;
+    __asm__ volatile("inl %1, %0" : "=a"(result) : "Nd"(port));
+    return result;
+}
+
+static inline void outl(uint16_t port, uint32_t data) {
+    __asm__ volatile("outl %0, %1" : : "a"(data), "Nd"(port));
+}
+
+// --- Ordering ---
+// Compiler barrier; x86 keeps ordinary stores in order, which is all a
+// device sharing write-back memory with us needs.
+static inline void barrier(void) {
+    __asm__ volatile("" : : : "memory");
+}
+
+// Full fence that also works on pre-SSE2 CPUs (no mfence on a Pentium).
+static inline void memory_fence(void) {
+    __asm__ volatile("lock; addl $0, (%%esp)" : : : "memory", "cc");
+}
+
+// --- Memory-mapped I/O ---
+// paging.c identity-maps the whole 4 GB, so device BARs below 4 GB are
+// reachable at their bus address. Everything past installed RAM is mapped
+// uncached (PCD|PWT) for them.
+static inline uint8_t mmio_read8(uint32_t addr) {
+    return *(volatile uint8_t*)addr;
+}
+
+static inline uint16_t mmio_read16(uint32_t addr) {
+    return *(volatile uint16_t*)addr;
+}
+
+static inline uint32_t mmio_read32(uint32_t addr) {
+    return *(volatile uint32_t*)addr;
+}
+
+static inline void mmio_write8(uint32_t addr, uint8_t value) {
+    *(volatile uint8_t*)addr = value;
+}
+
+static inline void mmio_write16(uint32_t addr, uint16_t value) {
+    *(volatile uint16_t*)addr = value;
+}
+
+static inline void mmio_write32(uint32_t addr, uint32_t value) {
+    *(volatile uint32_t*)addr = value;
+}
+
+static inline void cpu_relax(void) {
+    __asm__ volatile("pause" : : : "memory");
+}
+
+static inline void interrupts_enable(void) {
+    __asm__ volatile("sti" : : : "memory");
+}
+
+static inline uint32_t interrupts_save_disable(void) {
+    uint32_t eflags;
+    __asm__ volatile("pushfl; popl %0; cli" : "=r"(eflags) : : "memory");
+    return eflags;
+}
+
+static inline void interrupts_restore(uint32_t eflags) {
+    if (eflags & 0x200) __asm__ volatile("sti" : : : "memory");
+}
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void cpuid(uint32_t leaf, uint32_t subleaf,
+                         uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    __asm__ volatile("cpuid"
+                     : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                     : "a"(leaf), "c"(subleaf));
+}
+
+static inline uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t value) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+static inline uint64_t rdpmc(uint32_t counter) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(counter));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+#define CR0_MP          (1u << 1)   // WAIT/FWAIT honour CR0.TS
+#define CR0_EM          (1u << 2)   // x87/SSE instructions trap (no FPU)
+#define CR4_OSFXSR      (1u << 9)   // FXSAVE/FXRSTOR and SSE instructions enabled
+#define CR4_OSXMMEXCPT  (1u << 10)  // Unmasked SIMD FP exceptions raise #XM
+
+static inline uint32_t read_cr0(void) {
+    uint32_t value;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(uint32_t value) {
+    __asm__ volatile("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+static inline uint32_t read_cr4(void) {
+    uint32_t value;
+    __asm__ volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(uint32_t value) {
+    __asm__ volatile("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+// Turns on SSE for the kernel. Interrupt handlers are built without SSE and
+// there is a single kernel context, so XMM state is never saved or switched.
+static inline void sse_enable(void) {
+    write_cr0((read_cr0() & ~CR0_EM) | CR0_MP);
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+}
+
+// 64-by-32 unsigned division without libgcc's __udivdi3
+static inline uint64_t div64_u32(uint64_t dividend, uint32_t divisor) {
+    uint32_t high = (uint32_t)(dividend >> 32);
+    uint32_t low = (uint32_t)dividend;
+    uint32_t quotient_high = high / divisor;
+    uint32_t quotient_low, remainder;
+    high %= divisor;
+    __asm__("divl %4" : "=a"(quotient_low), "=d"(remainder) : "a"(low), "d"(high), "rm"(divisor));
+    return ((uint64_t)quotient_high << 32) | quotient_low;
+}
+
+// --- Library helpers (holographic_kernel.c) ---
+size_t strlen(const char *str);
+char *strncpy(char *dest, const char *src, size_t n);
+void *memcpy(void *dest, const void *src, size_t n);
+void *memset(void *dest, int value, size_t n);
+
+// --- Console output (holographic_kernel.c) ---
+void serial_init();
+void serial_write(char c);
+void serial_print(const char* str);
+void serial_print_hex(uint32_t value);
+void serial_print_dec(uint32_t value);
+void serial_print_dec64(uint64_t value);
+void print_char(char c, uint8_t color);
+void print(const char* str);
+void print_hex(uint32_t value);
+void console_set_muted(int muted);   // Drops serial_print/print output while set
+int console_is_muted();
+
+#endif
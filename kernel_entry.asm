@@ -4,12 +4,22 @@
 global _start
 
 extern kmain
+extern __bss_start
+extern __bss_end
 
 section .text
 _start:
+    cli
     mov esp, 0x90000
     cld
 
+    ; Zero .bss (it is not part of kernel.bin)
+    mov edi, __bss_start
+    mov ecx, __bss_end
+    sub ecx, edi
+    xor eax, eax
+    rep stosb
+
     mov eax, 0xb8000
     mov byte [eax], 'A'
     mov byte [eax+1], 0x0F
@@ -0,0 +1,162 @@
+// logq.c
+// Bounded ring after Vyukov's MPMC queue, used with a single consumer.
+// Slot i starts with sequence i. A producer that finds sequence == pos
+// claims it by advancing the enqueue position, fills it and publishes
+// pos + 1; the consumer reads slot pos when its sequence is pos + 1 and
+// hands it back for the next lap as pos + LOGQ_RECORDS.
+
+#include "kernel.h"
+#include "logq.h"
+
+#define LOGQ_MASK (LOGQ_RECORDS - 1)
+
+typedef struct {
+    volatile uint32_t sequence;
+    uint16_t cpu;
+    uint16_t length;
+    uint32_t cpu_sequence;
+    char text[LOGQ_TEXT_BYTES];
+} __attribute__((aligned(CACHE_LINE_SIZE))) LogRecord;
+
+typedef struct {
+    char text[LOGQ_TEXT_BYTES];
+    uint32_t length;
+    uint32_t sequence;          // Next record number from this core
+} __attribute__((aligned(CACHE_LINE_SIZE))) LogLineBuffer;
+
+static LogRecord ring[LOGQ_RECORDS];
+static LogLineBuffer line_buffers[MAX_CPUS];
+
+// Written by every producer and by the consumer respectively; kept apart
+static volatile uint32_t enqueue_position __attribute__((aligned(CACHE_LINE_SIZE)));
+static uint32_t dequeue_position __attribute__((aligned(CACHE_LINE_SIZE)));
+static uint32_t expected_sequence[MAX_CPUS];    // Consumer's view, for drop detection
+static volatile int running = 0;
+
+// Returns 0 when the ring is full
+static int publish(uint32_t cpu, const char* text, uint32_t length, uint32_t cpu_sequence) {
+    uint32_t position = __atomic_load_n(&enqueue_position, __ATOMIC_RELAXED);
+    LogRecord* record;
+    for (;;) {
+        record = &ring[position & LOGQ_MASK];
+        uint32_t sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+        int32_t difference = (int32_t)(sequence - position);
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&enqueue_position, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return 0;   // A full lap behind: the consumer has not freed this slot
+        } else {
+            position = __atomic_load_n(&enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    record->cpu = (uint16_t)cpu;
+    record->length = (uint16_t)length;
+    record->cpu_sequence = cpu_sequence;
+    memcpy(record->text, text, length);
+    __atomic_store_n(&record->sequence, position + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static void flush_line(uint32_t cpu) {
+    LogLineBuffer* buffer = &line_buffers[cpu];
+    if (buffer->length == 0) return;
+    // Dropped records still use up a sequence number, which is how the
+    // consumer counts them
+    publish(cpu, buffer->text, buffer->length, buffer->sequence++);
+    buffer->length = 0;
+}
+
+void logq_write(const char* str) {
+    uint32_t cpu = cpu_index();
+    LogLineBuffer* buffer = &line_buffers[cpu];
+    uint32_t flags = interrupts_save_disable();
+    while (*str != 0) {
+        char c = *str++;
+        buffer->text[buffer->length++] = c;
+        if (c == '\n' || buffer->length == LOGQ_TEXT_BYTES) flush_line(cpu);
+    }
+    interrupts_restore(flags);
+}
+
+// Consumer-side output goes straight to the UART; serial_print would
+// queue it again
+static void write_direct(const char* text, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) serial_write(text[i]);
+}
+
+static void write_string(const char* text) {
+    while (*text != 0) serial_write(*text++);
+}
+
+static void write_decimal(uint32_t value) {
+    char digits[11];
+    int position = 10;
+    digits[position] = '\0';
+    do {
+        digits[--position] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+    write_string(&digits[position]);
+}
+
+static void report_drops(uint32_t cpu, uint32_t dropped) {
+    write_string("[LOG] cpu=");
+    write_decimal(cpu);
+    write_string(" dropped=");
+    write_decimal(dropped);
+    write_string("\n");
+}
+
+uint32_t logq_drain() {
+    uint32_t drained = 0;
+    for (;;) {
+        LogRecord* record = &ring[dequeue_position & LOGQ_MASK];
+        if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != dequeue_position + 1) break;
+
+        if (record->cpu_sequence != expected_sequence[record->cpu]) {
+            report_drops(record->cpu, record->cpu_sequence - expected_sequence[record->cpu]);
+        }
+        expected_sequence[record->cpu] = record->cpu_sequence + 1;
+        write_direct(record->text, record->length);
+
+        __atomic_store_n(&record->sequence, dequeue_position + LOGQ_RECORDS, __ATOMIC_RELEASE);
+        dequeue_position++;
+        drained++;
+    }
+    return drained;
+}
+
+void logq_start() {
+    for (uint32_t i = 0; i < LOGQ_RECORDS; i++) ring[i].sequence = i;
+    enqueue_position = 0;
+    dequeue_position = 0;
+    for (uint32_t cpu = 0; cpu < MAX_CPUS; cpu++) {
+        line_buffers[cpu].length = 0;
+        line_buffers[cpu].sequence = 0;
+        expected_sequence[cpu] = 0;
+    }
+    running = 1;
+}
+
+void logq_stop() {
+    if (!running) return;
+    running = 0;
+    logq_drain();
+    // Drops after a core's last queued record show up only here; partial
+    // lines go last, as their records never made it into the ring
+    for (uint32_t cpu = 0; cpu < MAX_CPUS; cpu++) {
+        if (line_buffers[cpu].sequence != expected_sequence[cpu]) {
+            report_drops(cpu, line_buffers[cpu].sequence - expected_sequence[cpu]);
+        }
+        write_direct(line_buffers[cpu].text, line_buffers[cpu].length);
+        line_buffers[cpu].length = 0;
+    }
+}
+
+int logq_running() {
+    return running;
+}
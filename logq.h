@@ -0,0 +1,39 @@
+// logq.h
+// Lock-free multi-producer, single-consumer queue for serial log output.
+//
+// Once logq_start() has run, serial_print no longer touches the UART. Each
+// core gathers text in its own line buffer and publishes every completed
+// line (or a full buffer) as one record in a bounded ring, claiming the
+// slot with a compare-and-swap on the shared enqueue position. The main
+// loop drains the ring with logq_drain(), the only writer to the UART, so
+// lines from different cores never interleave mid-line.
+//
+// Producers never wait: when the ring is full the record is dropped. Every
+// record carries its core's sequence number, and the consumer reports the
+// gaps as
+//   [LOG] cpu=<n> dropped=<n>
+//
+// The line buffer is appended to with local interrupts off, so an IRQ
+// handler that logs cannot split a line in progress.
+
+#ifndef LOGQ_H
+#define LOGQ_H
+
+#include "kernel.h"
+
+#define LOGQ_RECORDS        512         // Power of two
+#define LOGQ_TEXT_BYTES     116         // Record is then two cache lines
+
+void logq_start();
+// Drains what is queued plus any partial lines, then goes back to writing
+// the UART directly (panic paths)
+void logq_stop();
+int logq_running();
+
+// Producer side, called by serial_print while the queue is running
+void logq_write(const char* str);
+
+// Writes out every record published so far; returns how many
+uint32_t logq_drain();
+
+#endif
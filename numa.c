@@ -0,0 +1,275 @@
+// numa.c
+// ACPI tables are read in place: the kernel runs on flat, identity-mapped
+// physical memory, and firmware keeps them below 4 GB.
+
+#include "kernel.h"
+#include "holographic.h"
+#include "numa.h"
+
+#define ACPI_EBDA_POINTER       0x40E
+#define ACPI_BIOS_AREA_START    0xE0000
+#define ACPI_BIOS_AREA_END      0x100000
+#define ACPI_HEADER_SIZE        36
+#define SRAT_ENTRIES_OFFSET     48      // Header plus 12 reserved bytes
+
+#define SRAT_PROCESSOR_AFFINITY 0
+#define SRAT_MEMORY_AFFINITY    1
+#define SRAT_X2APIC_AFFINITY    2
+#define SRAT_ENABLED            0x01
+
+typedef struct {
+    uint64_t base;
+    uint64_t length;
+    uint32_t node;
+} NumaRange;
+
+typedef struct {
+    uint32_t domain;            // ACPI proximity domain
+    uint32_t cpus;
+    uint64_t bytes;
+    uint64_t base;              // Lowest address described for the node
+} NumaNode;
+
+static NumaNode nodes[NUMA_MAX_NODES];
+static uint32_t node_count = 0;
+static NumaRange ranges[NUMA_MAX_RANGES];
+static uint32_t range_count = 0;
+static uint32_t srat_found = 0;
+
+// Node of each APIC id listed in the SRAT, for numa_current_node
+#define NUMA_MAX_APIC_IDS 256
+static uint8_t apic_node[NUMA_MAX_APIC_IDS];
+
+static uint32_t read32(const uint8_t* bytes) {
+    return bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static int checksum_ok(const uint8_t* bytes, uint32_t length) {
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++) sum += bytes[i];
+    return sum == 0;
+}
+
+static int signature_is(const uint8_t* bytes, const char* signature, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if (bytes[i] != (uint8_t)signature[i]) return 0;
+    }
+    return 1;
+}
+
+// "RSD PTR " on a 16-byte boundary in the first KB of the EBDA or in the
+// BIOS area, with a valid checksum over the ACPI 1.0 part
+static const uint8_t* find_rsdp_in(uint32_t start, uint32_t end) {
+    for (uint32_t address = start; address + 20 <= end; address += 16) {
+        const uint8_t* candidate = (const uint8_t*)address;
+        if (signature_is(candidate, "RSD PTR ", 8) && checksum_ok(candidate, 20)) return candidate;
+    }
+    return 0;
+}
+
+static const uint8_t* find_rsdp() {
+    uint32_t ebda = (uint32_t)(*(volatile uint16_t*)ACPI_EBDA_POINTER) << 4;
+    const uint8_t* rsdp = 0;
+    if (ebda >= 0x80000 && ebda < 0xA0000) rsdp = find_rsdp_in(ebda, ebda + 1024);
+    if (!rsdp) rsdp = find_rsdp_in(ACPI_BIOS_AREA_START, ACPI_BIOS_AREA_END);
+    return rsdp;
+}
+
+static const uint8_t* find_table(const char* signature) {
+    const uint8_t* rsdp = find_rsdp();
+    if (!rsdp) return 0;
+
+    // Prefer the RSDT (32-bit entries); fall back to XSDT entries that sit below 4 GB
+    uint32_t root = read32(rsdp + 16);
+    uint32_t entry_size = 4;
+    if (root == 0 && rsdp[15] >= 2 && read32(rsdp + 28) == 0) {
+        root = read32(rsdp + 24);
+        entry_size = 8;
+    }
+    if (root == 0) return 0;
+
+    const uint8_t* sdt = (const uint8_t*)root;
+    uint32_t length = read32(sdt + 4);
+    if (length < ACPI_HEADER_SIZE || !checksum_ok(sdt, length)) return 0;
+    for (uint32_t offset = ACPI_HEADER_SIZE; offset + entry_size <= length; offset += entry_size) {
+        if (entry_size == 8 && read32(sdt + offset + 4) != 0) continue;
+        const uint8_t* table = (const uint8_t*)read32(sdt + offset);
+        if (signature_is(table, signature, 4) && checksum_ok(table, read32(table + 4))) return table;
+    }
+    return 0;
+}
+
+static uint32_t node_for_domain(uint32_t domain) {
+    for (uint32_t n = 0; n < node_count; n++) {
+        if (nodes[n].domain == domain) return n;
+    }
+    if (node_count == NUMA_MAX_NODES) return NUMA_MAX_NODES - 1;
+    nodes[node_count].domain = domain;
+    nodes[node_count].base = ~(uint64_t)0;
+    return node_count++;
+}
+
+static void add_cpu(uint32_t apic_id, uint32_t domain) {
+    uint32_t node = node_for_domain(domain);
+    nodes[node].cpus++;
+    if (apic_id < NUMA_MAX_APIC_IDS) apic_node[apic_id] = node;
+}
+
+static void parse_srat(const uint8_t* srat) {
+    uint32_t length = read32(srat + 4);
+    uint32_t offset = SRAT_ENTRIES_OFFSET;
+    while (offset + 2 <= length) {
+        const uint8_t* entry = srat + offset;
+        uint8_t entry_length = entry[1];
+        if (entry_length < 2 || offset + entry_length > length) break;
+
+        if (entry[0] == SRAT_PROCESSOR_AFFINITY && entry_length >= 16 && (read32(entry + 4) & SRAT_ENABLED)) {
+            uint32_t domain = entry[2] | ((uint32_t)entry[9] << 8) | ((uint32_t)entry[10] << 16) |
+                              ((uint32_t)entry[11] << 24);
+            add_cpu(entry[3], domain);
+        } else if (entry[0] == SRAT_X2APIC_AFFINITY && entry_length >= 24 && (read32(entry + 12) & SRAT_ENABLED)) {
+            add_cpu(read32(entry + 8), read32(entry + 4));
+        } else if (entry[0] == SRAT_MEMORY_AFFINITY && entry_length >= 40 && (read32(entry + 28) & SRAT_ENABLED)) {
+            uint64_t base = read32(entry + 8) | ((uint64_t)read32(entry + 12) << 32);
+            uint64_t bytes = read32(entry + 16) | ((uint64_t)read32(entry + 20) << 32);
+            uint32_t node = node_for_domain(read32(entry + 2));
+            nodes[node].bytes += bytes;
+            if (base < nodes[node].base) nodes[node].base = base;
+            if (range_count < NUMA_MAX_RANGES && bytes) {
+                ranges[range_count].base = base;
+                ranges[range_count].length = bytes;
+                ranges[range_count].node = node;
+                range_count++;
+            }
+        }
+        offset += entry_length;
+    }
+}
+
+uint32_t numa_init() {
+    const uint8_t* srat = find_table("SRAT");
+    if (srat) {
+        srat_found = 1;
+        parse_srat(srat);
+    }
+    if (node_count == 0) {
+        node_count = 1;
+        nodes[0].domain = 0;
+        nodes[0].base = 0;
+    }
+    serial_print("[NUMA] nodes=");
+    serial_print_dec(node_count);
+    serial_print(" srat=");
+    serial_print_dec(srat_found);
+    serial_print(" ranges=");
+    serial_print_dec(range_count);
+    serial_print("\n");
+    return node_count;
+}
+
+uint32_t numa_node_count() {
+    return node_count ? node_count : 1;
+}
+
+uint32_t numa_node_of_address(uint32_t address) {
+    for (uint32_t r = 0; r < range_count; r++) {
+        if (address >= ranges[r].base && address - ranges[r].base < ranges[r].length) return ranges[r].node;
+    }
+    return 0;
+}
+
+uint32_t numa_current_node() {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    return apic_node[ebx >> 24];
+}
+
+void numa_assign_shards() {
+    uint32_t shard_nodes[HOLO_MAX_SHARDS];
+    uint32_t count = numa_node_count();
+    if (count > HOLO_MAX_SHARDS) count = HOLO_MAX_SHARDS;
+    for (uint32_t n = 0; n < count; n++) shard_nodes[n] = n;
+    holographic_partition_shards(count, shard_nodes);
+}
+
+// Bytes of [start, start + bytes) the SRAT places on `node`
+static uint32_t resident_bytes(uint32_t node, uint32_t start, uint32_t bytes) {
+    if (range_count == 0) return node == 0 ? bytes : 0;
+    uint32_t total = 0;
+    for (uint32_t r = 0; r < range_count; r++) {
+        if (ranges[r].node != node) continue;
+        uint64_t low = ranges[r].base > start ? ranges[r].base : start;
+        uint64_t high = ranges[r].base + ranges[r].length;
+        if (high > (uint64_t)start + bytes) high = (uint64_t)start + bytes;
+        if (high > low) total += (uint32_t)(high - low);
+    }
+    return total;
+}
+
+void numa_print_summary() {
+    uint32_t cpu_node = numa_current_node();
+    serial_print("[NUMA] nodes=");
+    serial_print_dec(numa_node_count());
+    serial_print(" srat=");
+    serial_print_dec(srat_found);
+    serial_print(" cpu_node=");
+    serial_print_dec(cpu_node);
+    serial_print("\n");
+
+    // Every visit is made by this CPU; it is remote when the shard's slots
+    // live on another node
+    uint32_t local_visits[NUMA_MAX_NODES] = { 0 };
+    uint32_t remote_visits[NUMA_MAX_NODES] = { 0 };
+    for (uint32_t s = 0; s < holo_shard_count; s++) {
+        uint32_t storage_node = numa_node_of_address((uint32_t)&entity_pool[holo_shards[s].first]);
+        if (storage_node == cpu_node) {
+            local_visits[storage_node] += holo_shards[s].visits;
+        } else {
+            remote_visits[storage_node] += holo_shards[s].visits;
+        }
+    }
+
+    for (uint32_t n = 0; n < numa_node_count(); n++) {
+        uint32_t pool_bytes = resident_bytes(n, (uint32_t)&holo_system, sizeof(holo_system)) +
+                              resident_bytes(n, (uint32_t)entity_pool, sizeof(entity_pool)) +
+                              resident_bytes(n, (uint32_t)holographic_slab_base(), holographic_slab_bytes());
+        serial_print("[NUMA] node=");
+        serial_print_dec(n);
+        serial_print(" base=");
+        serial_print_hex(nodes[n].bytes ? (uint32_t)nodes[n].base : 0);
+        serial_print(" bytes=");
+        serial_print_dec64(nodes[n].bytes);
+        serial_print(" cpus=");
+        serial_print_dec(nodes[n].cpus);
+        serial_print(" pool_bytes=");
+        serial_print_dec(pool_bytes);
+        serial_print(" local_visits=");
+        serial_print_dec(local_visits[n]);
+        serial_print(" remote_visits=");
+        serial_print_dec(remote_visits[n]);
+        serial_print("\n");
+    }
+
+    for (uint32_t s = 0; s < holo_shard_count; s++) {
+        HoloShard* shard = &holo_shards[s];
+        serial_print("[NUMA] shard=");
+        serial_print_dec(s);
+        serial_print(" node=");
+        serial_print_dec(shard->node);
+        serial_print(" storage_node=");
+        serial_print_dec(numa_node_of_address((uint32_t)&entity_pool[shard->first]));
+        serial_print(" first=");
+        serial_print_dec(shard->first);
+        serial_print(" slots=");
+        serial_print_dec(shard->count);
+        serial_print(" visits=");
+        serial_print_dec(shard->visits);
+        serial_print(" halo_reads=");
+        serial_print_dec(shard->halo_reads);
+        serial_print(" load=");
+        serial_print_dec(shard->load);
+        serial_print(" migrated=");
+        serial_print_dec(shard->migrated);
+        serial_print("\n");
+    }
+}
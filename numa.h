@@ -0,0 +1,39 @@
+// numa.h
+// NUMA topology from the ACPI SRAT (present when QEMU runs with -numa).
+//
+// numa_init finds the RSDP, walks the RSDT (or XSDT) to the SRAT and files
+// every enabled memory range and processor under a dense node number,
+// proximity domains numbered in order of first appearance. Without an SRAT
+// the machine is one node covering all memory.
+//
+// The kernel is uniprocessor, so the boot CPU services every shard.
+// numa_assign_shards still gives each node its own shard of the entity
+// pool, so the partition and the counters are the ones an SMP kernel
+// would have. The summary shows where the pools are resident and how many
+// entity visits crossed nodes:
+//   [NUMA] nodes=<n> srat=<0|1> cpu_node=<n>
+//   [NUMA] node=<n> base=<hex> bytes=<n> cpus=<n> pool_bytes=<n> local_visits=<n> remote_visits=<n>
+//   [NUMA] shard=<n> node=<n> storage_node=<n> first=<n> slots=<n> visits=<n> halo_reads=<n>
+//          load=<cycles per generation> migrated=<slots>
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include "kernel.h"
+
+#define NUMA_MAX_NODES  8
+#define NUMA_MAX_RANGES 16
+
+// Returns the number of nodes (1 when there is no SRAT)
+uint32_t numa_init();
+uint32_t numa_node_count();
+// Node of a physical address; 0 for memory the SRAT does not describe
+uint32_t numa_node_of_address(uint32_t address);
+// Node of the CPU running this code
+uint32_t numa_current_node();
+
+// One shard of the entity pool per node, in node order
+void numa_assign_shards();
+void numa_print_summary();
+
+#endif
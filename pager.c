@@ -0,0 +1,192 @@
+// pager.c
+// Window pages are numbered from PAGER_VIRTUAL_BASE; page n lives at
+// sector PAGER_BASE_LBA + n * PAGER_SECTORS_PER_PAGE of the disk. Frames are
+// identity-mapped RAM, so their addresses go to the device as they are.
+// Faults are serviced inside the page-fault handler with polled I/O; only
+// the simulation core touches the window, never the disk driver itself.
+
+#include "kernel.h"
+#include "paging.h"
+#include "virtio_blk.h"
+#include "hdr_histogram.h"
+#include "pager.h"
+
+#define PAGER_WINDOW_PAGES      (PAGER_MAX_BYTES / PAGE_SIZE)
+#define PAGER_SECTORS_PER_PAGE  (PAGE_SIZE / VIRTIO_BLK_SECTOR_SIZE)
+#define PAGER_NO_PAGE           0xFFFFFFFF
+
+HdrHistogram pager_fault_latency;
+
+static uint32_t window_tables[PAGER_MAX_BYTES / PAGING_LARGE_PAGE_SIZE][1024] __attribute__((aligned(PAGE_SIZE)));
+// Set for pages whose contents are on disk; the others read as zero
+static uint8_t backed[PAGER_WINDOW_PAGES / 8];
+static uint32_t frame_page[PAGER_RESIDENT_PAGES];  // Window page held by each frame
+static uint32_t frame_base = 0;
+static uint32_t frames_used = 0;
+static uint32_t clock_hand = 0;
+static uint32_t window_bytes = 0;
+
+static uint32_t faults = 0;
+static uint32_t disk_reads = 0;
+static uint32_t zero_fills = 0;
+static uint32_t writebacks = 0;
+static uint32_t evictions = 0;
+
+static uint32_t* entry_of(uint32_t page) {
+    return &window_tables[page >> 10][page & 1023];
+}
+
+static uint32_t address_of(uint32_t page) {
+    return PAGER_VIRTUAL_BASE + (page << PAGE_SHIFT);
+}
+
+static uint32_t frame_address(uint32_t frame) {
+    return frame_base + (frame << PAGE_SHIFT);
+}
+
+static uint32_t page_lba(uint32_t page) {
+    return PAGER_BASE_LBA + page * PAGER_SECTORS_PER_PAGE;
+}
+
+// Writes a resident page to disk if the CPU has dirtied it since it was
+// loaded or last written; returns 0 on an I/O error
+static int write_back(uint32_t frame) {
+    uint32_t page = frame_page[frame];
+    uint32_t* entry = entry_of(page);
+    if (!(*entry & PAGE_DIRTY)) return 1;
+    if (virtio_blk_write(page_lba(page), (const void*)frame_address(frame), PAGER_SECTORS_PER_PAGE) != 0) {
+        return 0;
+    }
+    *entry &= ~(uint32_t)PAGE_DIRTY;
+    paging_invalidate(address_of(page));
+    backed[page >> 3] |= (uint8_t)(1u << (page & 7));
+    writebacks++;
+    return 1;
+}
+
+// A free frame, or the first one the clock hand finds not accessed since
+// its last pass; PAGER_NO_PAGE when the victim cannot be written back
+static uint32_t take_frame() {
+    if (frames_used < PAGER_RESIDENT_PAGES) return frames_used++;
+
+    for (;;) {
+        uint32_t frame = clock_hand;
+        clock_hand = (clock_hand + 1) % PAGER_RESIDENT_PAGES;
+        uint32_t page = frame_page[frame];
+        uint32_t* entry = entry_of(page);
+        if (*entry & PAGE_ACCESSED) {
+            // The TLB entry has to go too, or the next access won't set the bit
+            *entry &= ~(uint32_t)PAGE_ACCESSED;
+            paging_invalidate(address_of(page));
+            continue;
+        }
+        if (!write_back(frame)) return PAGER_NO_PAGE;
+        *entry = 0;
+        paging_invalidate(address_of(page));
+        evictions++;
+        return frame;
+    }
+}
+
+static int pager_fault(uint32_t address) {
+    if (address - PAGER_VIRTUAL_BASE >= window_bytes) return 0;
+
+    uint64_t start = rdtsc();
+    uint32_t page = (address - PAGER_VIRTUAL_BASE) >> PAGE_SHIFT;
+    uint32_t frame = take_frame();
+    if (frame == PAGER_NO_PAGE) {
+        serial_print("[PAGER] Error: write-back failed.\n");
+        return 0;
+    }
+
+    void* storage = (void*)frame_address(frame);
+    if (backed[page >> 3] & (1u << (page & 7))) {
+        if (virtio_blk_read(page_lba(page), storage, PAGER_SECTORS_PER_PAGE) != 0) {
+            serial_print("[PAGER] Error: page read failed.\n");
+            return 0;
+        }
+        disk_reads++;
+    } else {
+        memset(storage, 0, PAGE_SIZE);
+        zero_fills++;
+    }
+
+    frame_page[frame] = page;
+    *entry_of(page) = frame_address(frame) | PAGE_PRESENT | PAGE_WRITABLE;
+    faults++;
+    hdr_record(&pager_fault_latency, rdtsc() - start);
+    return 1;
+}
+
+int pager_init(uint32_t bytes) {
+    hdr_init(&pager_fault_latency, "pager_fault");
+    bytes = (bytes + PAGE_SIZE - 1) & ~(uint32_t)(PAGE_SIZE - 1);
+    if (!paging_enabled() || !virtio_blk_present() || bytes > PAGER_MAX_BYTES ||
+        paging_ram_bytes() > PAGER_VIRTUAL_BASE) {
+        serial_print("[PAGER] Error: needs paging, a disk and a window of at most 512 MB above RAM.\n");
+        return 0;
+    }
+    if (page_lba(bytes / PAGE_SIZE) > virtio_blk_capacity()) {
+        serial_print("[PAGER] Error: disk too small for the backing image.\n");
+        return 0;
+    }
+    frame_base = paging_reserve(PAGER_RESIDENT_PAGES * PAGE_SIZE);
+    if (!frame_base) {
+        serial_print("[PAGER] Error: not enough RAM for the resident frames.\n");
+        return 0;
+    }
+
+    window_bytes = bytes;
+    memset(backed, 0xFF, sizeof(backed));
+    for (uint32_t t = 0; t * PAGING_LARGE_PAGE_SIZE < bytes; t++) {
+        memset(window_tables[t], 0, sizeof(window_tables[t]));
+        paging_map_table(PAGER_VIRTUAL_BASE + t * PAGING_LARGE_PAGE_SIZE, window_tables[t]);
+    }
+    paging_set_missing_page_hook(pager_fault);
+
+    serial_print("[PAGER] window=");
+    serial_print_dec(window_bytes);
+    serial_print(" at ");
+    serial_print_hex(PAGER_VIRTUAL_BASE);
+    serial_print(" frames=");
+    serial_print_dec(PAGER_RESIDENT_PAGES);
+    serial_print(" ram=");
+    serial_print_dec(paging_ram_bytes());
+    serial_print("\n");
+    return 1;
+}
+
+void* pager_window() {
+    return (void*)PAGER_VIRTUAL_BASE;
+}
+
+void pager_discard() {
+    for (uint32_t frame = 0; frame < frames_used; frame++) {
+        *entry_of(frame_page[frame]) = 0;
+    }
+    paging_flush_tlb();
+    frames_used = 0;
+    clock_hand = 0;
+    memset(backed, 0, sizeof(backed));
+}
+
+void pager_print_summary() {
+    serial_print("[PAGER] window=");
+    serial_print_dec(window_bytes);
+    serial_print(" frames=");
+    serial_print_dec(PAGER_RESIDENT_PAGES);
+    serial_print(" resident=");
+    serial_print_dec(frames_used);
+    serial_print(" faults=");
+    serial_print_dec(faults);
+    serial_print(" disk_reads=");
+    serial_print_dec(disk_reads);
+    serial_print(" zero_fills=");
+    serial_print_dec(zero_fills);
+    serial_print(" writebacks=");
+    serial_print_dec(writebacks);
+    serial_print(" evictions=");
+    serial_print_dec(evictions);
+    serial_print("\n");
+    hdr_print(&pager_fault_latency);
+}
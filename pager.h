@@ -0,0 +1,52 @@
+// pager.h
+// Demand-paged, disk-backed window for the memory-pool vectors (make
+// PAGED_MEMORY=1).
+//
+// The window is virtual address space above guest RAM whose page-table
+// entries start out not present. The first touch of a page faults; the
+// pager gives it one of PAGER_RESIDENT_PAGES frames and fills it from the
+// checkpoint disk (or with zeros, for a page that was never written out).
+// When every frame is in use a clock hand picks the victim: pages the CPU
+// has marked accessed since the last sweep get a second chance, and a
+// victim the CPU has marked dirty is written back before its frame is
+// reused. The pool can therefore be much larger than RAM, and a recall
+// costs at most one eviction write plus one read.
+//
+// The backing image sits at PAGER_BASE_LBA, past the checkpoint and the
+// replay log, and is updated in place. It only lives for one boot: paged
+// builds take no checkpoints (checkpoint.h), and every boot starts from
+// pager_discard(). BENCH_ON_BOOT fills the pool too, and overwrites the
+// image with it.
+//   [PAGER] window=<bytes> at <hex> frames=<n> ram=<bytes>          (pager_init)
+//   [PAGER] window=<bytes> frames=<n> resident=<n> faults=<n> disk_reads=<n> zero_fills=<n>
+//           writebacks=<n> evictions=<n>
+//   [HDR] pager_fault ...        (cycles to service one fault)
+
+#ifndef PAGER_H
+#define PAGER_H
+
+#include "kernel.h"
+#include "hdr_histogram.h"
+
+#define PAGER_VIRTUAL_BASE      0x40000000      // 1 GB; guest RAM must end below it
+#define PAGER_MAX_BYTES         (512u << 20)
+#define PAGER_BASE_LBA          16384           // 8 MB into the checkpoint disk
+#ifndef PAGER_RESIDENT_PAGES
+#define PAGER_RESIDENT_PAGES    1024            // 4 MB of frames
+#endif
+
+extern HdrHistogram pager_fault_latency;
+
+// Maps a window of `bytes` and takes its frames. Needs paging, the disk and
+// room on it; returns 1 on success. Every page then reads back what the
+// backing image holds.
+int pager_init(uint32_t bytes);
+void* pager_window();
+
+// Drops every page without writing it back; the whole window reads as zero
+// afterwards (a fresh pool)
+void pager_discard();
+
+void pager_print_summary();
+
+#endif
@@ -0,0 +1,158 @@
+// paging.c
+// One page directory, built once at boot. Its own tables are never freed
+// or remapped, only the writable bit of small-page entries changes; other
+// mappings come from tables a driver hangs off it (pager.c).
+
+#include "kernel.h"
+#include "idt.h"
+#include "paging.h"
+
+#define CMOS_INDEX              0x70
+#define CMOS_DATA               0x71
+#define CMOS_EXTENDED_KB_LOW    0x30    // RAM from 1 MB to 64 MB, in KB
+#define CMOS_EXTENDED_KB_HIGH   0x31
+#define CMOS_ABOVE_16M_LOW      0x34    // RAM above 16 MB, in 64 KB blocks
+#define CMOS_ABOVE_16M_HIGH     0x35
+
+#define CPUID_EDX_PSE           (1u << 3)
+#define VGA_WINDOW_START        0xA0000
+#define VGA_WINDOW_END          0xC0000
+
+extern char __bss_end[];
+
+static uint32_t page_directory[1024] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t page_tables[PAGING_MAX_SMALL_TABLES][1024] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t small_limit = 0;
+static int enabled = 0;
+static uint32_t reserved_bytes = 0;
+static page_fault_hook_t write_fault_hook = 0;
+static page_fault_hook_t missing_page_hook = 0;
+
+static uint8_t cmos_read(uint8_t index) {
+    outb(CMOS_INDEX, index);
+    return inb(CMOS_DATA);
+}
+
+uint32_t paging_ram_bytes() {
+    uint32_t blocks = cmos_read(CMOS_ABOVE_16M_LOW) | ((uint32_t)cmos_read(CMOS_ABOVE_16M_HIGH) << 8);
+    if (blocks) return (16u << 20) + (blocks << 16);
+    uint32_t kilobytes = cmos_read(CMOS_EXTENDED_KB_LOW) | ((uint32_t)cmos_read(CMOS_EXTENDED_KB_HIGH) << 8);
+    return (1u << 20) + (kilobytes << 10);
+}
+
+static uint32_t kernel_end() {
+    return ((uint32_t)__bss_end + PAGE_SIZE - 1) & ~(uint32_t)(PAGE_SIZE - 1);
+}
+
+uint32_t paging_free_base() {
+    return kernel_end() + reserved_bytes;
+}
+
+uint32_t paging_reserve(uint32_t bytes) {
+    uint32_t base = paging_free_base();
+    bytes = (bytes + PAGE_SIZE - 1) & ~(uint32_t)(PAGE_SIZE - 1);
+    if (paging_ram_bytes() < base || bytes > paging_ram_bytes() - base) return 0;
+    reserved_bytes += bytes;
+    return base;
+}
+
+uint32_t paging_small_limit() {
+    return small_limit;
+}
+
+int paging_enabled() {
+    return enabled;
+}
+
+static void page_fault(InterruptFrame* frame) {
+    uint32_t address;
+    __asm__ volatile("mov %%cr2, %0" : "=r"(address));
+    uint32_t write_to_present = PAGE_FAULT_PRESENT | PAGE_FAULT_WRITE;
+    if ((frame->error_code & write_to_present) == write_to_present) {
+        if (write_fault_hook && write_fault_hook(address)) return;
+    } else if (!(frame->error_code & PAGE_FAULT_PRESENT)) {
+        if (missing_page_hook && missing_page_hook(address)) return;
+    }
+    exception_panic(frame);
+}
+
+void paging_set_write_fault_hook(page_fault_hook_t hook) {
+    write_fault_hook = hook;
+}
+
+void paging_set_missing_page_hook(page_fault_hook_t hook) {
+    missing_page_hook = hook;
+}
+
+void paging_map_table(uint32_t address, uint32_t* table) {
+    page_directory[address >> 22] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITABLE;
+    paging_flush_tlb();
+}
+
+static void set_writable(uint32_t start, uint32_t bytes, int writable) {
+    if (!enabled || bytes == 0) return;
+    uint32_t end = start + bytes;
+    if (end > small_limit) end = small_limit;
+    for (uint32_t page = start & ~(uint32_t)(PAGE_SIZE - 1); page < end; page += PAGE_SIZE) {
+        uint32_t* entry = &page_tables[page >> 22][(page >> PAGE_SHIFT) & 1023];
+        if (writable) {
+            *entry |= PAGE_WRITABLE;
+        } else {
+            *entry &= ~(uint32_t)PAGE_WRITABLE;
+        }
+    }
+}
+
+void paging_protect(uint32_t start, uint32_t bytes) {
+    set_writable(start, bytes, 0);
+}
+
+void paging_unprotect(uint32_t start, uint32_t bytes) {
+    set_writable(start, bytes, 1);
+}
+
+void paging_flush_tlb() {
+    __asm__ volatile("mov %%cr3, %%eax\n\tmov %%eax, %%cr3" : : : "eax", "memory");
+}
+
+int paging_init() {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+
+    uint32_t tables = (kernel_end() + PAGING_LARGE_PAGE_SIZE - 1) / PAGING_LARGE_PAGE_SIZE;
+    if (!(edx & CPUID_EDX_PSE) || tables > PAGING_MAX_SMALL_TABLES) {
+        serial_print("[PAGING] enabled=0\n");
+        return 0;
+    }
+
+    small_limit = tables * PAGING_LARGE_PAGE_SIZE;
+    for (uint32_t t = 0; t < tables; t++) {
+        for (uint32_t i = 0; i < 1024; i++) {
+            uint32_t address = (t << 22) | (i << PAGE_SHIFT);
+            uint32_t cache = address >= VGA_WINDOW_START && address < VGA_WINDOW_END ? PAGE_UNCACHED : 0;
+            page_tables[t][i] = address | PAGE_PRESENT | PAGE_WRITABLE | cache;
+        }
+        page_directory[t] = (uint32_t)page_tables[t] | PAGE_PRESENT | PAGE_WRITABLE;
+    }
+    // A large page holding any RAM stays cacheable; past that it is devices
+    uint32_t first_device = (paging_ram_bytes() + PAGING_LARGE_PAGE_SIZE - 1) / PAGING_LARGE_PAGE_SIZE;
+    for (uint32_t t = tables; t < 1024; t++) {
+        uint32_t cache = t >= first_device ? PAGE_UNCACHED : 0;
+        page_directory[t] = (t << 22) | PAGE_LARGE | PAGE_PRESENT | PAGE_WRITABLE | cache;
+    }
+
+    interrupt_register(EXCEPTION_PAGE_FAULT, page_fault);
+    write_cr4(read_cr4() | CR4_PSE);
+    __asm__ volatile("mov %0, %%cr3" : : "r"(page_directory) : "memory");
+    write_cr0(read_cr0() | CR0_PG | CR0_WP);
+    enabled = 1;
+
+    serial_print("[PAGING] enabled=1 small_pages_below=");
+    serial_print_hex(small_limit);
+    serial_print(" ram=");
+    serial_print_dec(paging_ram_bytes());
+    serial_print(" free_base=");
+    serial_print_hex(paging_free_base());
+    serial_print("\n");
+    return 1;
+}
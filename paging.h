@@ -0,0 +1,81 @@
+// paging.h
+// Identity-mapped paging, enabled so single pool pages can be made
+// read-only for copy-on-write checkpoints.
+//
+// Addresses below the end of the kernel image (rounded up to 4 MB) go through
+// 4 KB page tables; everything above, RAM and device MMIO alike, is mapped
+// with 4 MB pages. The 4 MB pages past installed RAM (PCI BARs, the APICs)
+// and the legacy VGA window are cache-disabled and write-through, so
+// device registers never sit in the cache. CR0.WP is set, so ring-0 writes to a page that
+// paging_protect() has cleared honour the protection and raise a page
+// fault. Write faults on present pages go to the hook set with
+// paging_set_write_fault_hook(), faults on missing pages to the one set
+// with paging_set_missing_page_hook(). Any fault a hook declines panics as
+// before. Without PSE the kernel stays unpaged and paging_init returns 0.
+//
+// RAM above the kernel image is handed out with paging_reserve(); what is
+// left from paging_free_base() up is scratch for the checkpoint snapshots.
+//   [PAGING] enabled=<0|1> small_pages_below=<hex> ram=<bytes> free_base=<hex>
+
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "kernel.h"
+
+#define PAGE_SIZE               4096
+#define PAGE_SHIFT              12
+#define PAGING_LARGE_PAGE_SIZE  (4u << 20)
+#define PAGING_MAX_SMALL_TABLES 8       // 4 KB mappings for the first 32 MB
+
+#define PAGE_PRESENT    0x001
+#define PAGE_WRITABLE   0x002
+#define PAGE_WRITE_THROUGH  0x008
+#define PAGE_CACHE_DISABLE  0x010
+#define PAGE_UNCACHED   (PAGE_CACHE_DISABLE | PAGE_WRITE_THROUGH)
+#define PAGE_ACCESSED   0x020           // Set by the CPU on any access
+#define PAGE_DIRTY      0x040           // Set by the CPU on a write
+#define PAGE_LARGE      0x080
+
+#define PAGE_FAULT_PRESENT  0x1         // Error code bits
+#define PAGE_FAULT_WRITE    0x2
+
+#define CR0_WP          (1u << 16)      // Supervisor writes honour read-only pages
+#define CR0_PG          (1u << 31)
+#define CR4_PSE         (1u << 4)
+
+// Returns 1 once paging is on
+int paging_init();
+int paging_enabled();
+
+// Installed RAM, from the CMOS memory size registers
+uint32_t paging_ram_bytes();
+// First page-aligned address past the kernel image (.bss included) and
+// the reservations made so far
+uint32_t paging_free_base();
+// Takes `bytes` (rounded up to pages) of RAM at paging_free_base() for a
+// driver's own frames; returns the physical address, or 0 when RAM is short
+uint32_t paging_reserve(uint32_t bytes);
+// End of the range paging_protect can act on
+uint32_t paging_small_limit();
+
+// Clear or set the writable bit on every 4 KB page overlapping
+// [start, start + bytes). The caller reloads the TLB: paging_flush_tlb()
+// after a batch, paging_invalidate() for one page.
+void paging_protect(uint32_t start, uint32_t bytes);
+void paging_unprotect(uint32_t start, uint32_t bytes);
+void paging_flush_tlb();
+
+static inline void paging_invalidate(uint32_t address) {
+    __asm__ volatile("invlpg (%0)" : : "r"(address) : "memory");
+}
+
+// Points the 4 MB of address space at `address` (4 MB aligned) at a page
+// table the caller owns, replacing the identity-mapped large page
+void paging_map_table(uint32_t address, uint32_t* table);
+
+// Both hooks return 1 when they have made the faulting access safe to retry
+typedef int (*page_fault_hook_t)(uint32_t address);
+void paging_set_write_fault_hook(page_fault_hook_t hook);
+void paging_set_missing_page_hook(page_fault_hook_t hook);
+
+#endif
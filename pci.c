@@ -0,0 +1,110 @@
+// pci.c
+
+#include "kernel.h"
+#include "pci.h"
+
+static uint32_t pci_address(const PciDevice* dev, uint8_t offset) {
+    return 0x80000000U |
+           ((uint32_t)dev->bus << 16) |
+           ((uint32_t)dev->slot << 11) |
+           ((uint32_t)dev->function << 8) |
+           (offset & 0xFC);
+}
+
+uint32_t pci_config_read32(const PciDevice* dev, uint8_t offset) {
+    outl(PCI_CONFIG_ADDRESS, pci_address(dev, offset));
+    return inl(PCI_CONFIG_DATA);
+}
+
+uint16_t pci_config_read16(const PciDevice* dev, uint8_t offset) {
+    uint32_t value = pci_config_read32(dev, offset);
+    return (uint16_t)(value >> ((offset & 2) * 8));
+}
+
+uint8_t pci_config_read8(const PciDevice* dev, uint8_t offset) {
+    uint32_t value = pci_config_read32(dev, offset);
+    return (uint8_t)(value >> ((offset & 3) * 8));
+}
+
+void pci_config_write32(const PciDevice* dev, uint8_t offset, uint32_t value) {
+    outl(PCI_CONFIG_ADDRESS, pci_address(dev, offset));
+    outl(PCI_CONFIG_DATA, value);
+}
+
+void pci_config_write16(const PciDevice* dev, uint8_t offset, uint16_t value) {
+    uint32_t current = pci_config_read32(dev, offset);
+    int shift = (offset & 2) * 8;
+    current &= ~(0xFFFFU << shift);
+    current |= (uint32_t)value << shift;
+    pci_config_write32(dev, offset, current);
+}
+
+int pci_find_device(uint16_t vendor_id, uint16_t device_id, PciDevice* out) {
+    PciDevice probe = {0};
+
+    for (int bus = 0; bus < 256; bus++) {
+        for (int slot = 0; slot < 32; slot++) {
+            for (int function = 0; function < 8; function++) {
+                probe.bus = bus;
+                probe.slot = slot;
+                probe.function = function;
+
+                uint32_t id = pci_config_read32(&probe, PCI_VENDOR_ID);
+                if ((id & 0xFFFF) == 0xFFFF) {
+                    if (function == 0) break;
+                    continue;
+                }
+
+                if ((id & 0xFFFF) == vendor_id && (id >> 16) == device_id) {
+                    probe.vendor_id = vendor_id;
+                    probe.device_id = device_id;
+                    probe.irq_line = pci_config_read8(&probe, PCI_INTERRUPT_LINE);
+                    *out = probe;
+                    return 1;
+                }
+
+                // Single-function devices only answer on function 0
+                if (function == 0 && !(pci_config_read8(&probe, PCI_HEADER_TYPE) & 0x80)) break;
+            }
+        }
+    }
+    return 0;
+}
+
+uint32_t pci_bar_address(const PciDevice* dev, int bar, uint8_t* is_io) {
+    uint8_t offset = PCI_BAR0 + bar * 4;
+    uint32_t value = pci_config_read32(dev, offset);
+
+    if (value & 0x1) {
+        *is_io = 1;
+        return value & ~0x3U;
+    }
+
+    *is_io = 0;
+    if (((value >> 1) & 0x3) == 0x2) {
+        // 64-bit memory BAR: the next slot holds the high half
+        uint32_t high = pci_config_read32(dev, offset + 4);
+        if (high != 0) return 0;
+    }
+    return value & ~0xFU;
+}
+
+uint32_t pci_bar_size(const PciDevice* dev, int bar) {
+    uint8_t offset = PCI_BAR0 + bar * 4;
+    uint16_t command = pci_config_read16(dev, PCI_COMMAND);
+    uint32_t original = pci_config_read32(dev, offset);
+
+    pci_config_write16(dev, PCI_COMMAND, command & ~(PCI_COMMAND_IO | PCI_COMMAND_MEMORY));
+    pci_config_write32(dev, offset, 0xFFFFFFFFU);
+    uint32_t mask = pci_config_read32(dev, offset);
+    pci_config_write32(dev, offset, original);
+    pci_config_write16(dev, PCI_COMMAND, command);
+
+    mask &= (original & 0x1) ? ~0x3U : ~0xFU;
+    return mask ? (~mask + 1) : 0;
+}
+
+void pci_enable(const PciDevice* dev, uint16_t command_bits) {
+    uint16_t command = pci_config_read16(dev, PCI_COMMAND);
+    pci_config_write16(dev, PCI_COMMAND, command | command_bits);
+}
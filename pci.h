@@ -0,0 +1,58 @@
+// pci.h
+// PCI configuration space access (mechanism #1, ports 0xCF8/0xCFC).
+
+#ifndef PCI_H
+#define PCI_H
+
+#include "kernel.h"
+
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA    0xCFC
+
+// Standard configuration header offsets
+#define PCI_VENDOR_ID      0x00
+#define PCI_DEVICE_ID      0x02
+#define PCI_COMMAND        0x04
+#define PCI_STATUS         0x06
+#define PCI_HEADER_TYPE    0x0E
+#define PCI_BAR0           0x10
+#define PCI_CAPABILITY_PTR 0x34
+#define PCI_INTERRUPT_LINE 0x3C
+
+#define PCI_COMMAND_IO          0x0001
+#define PCI_COMMAND_MEMORY      0x0002
+#define PCI_COMMAND_BUS_MASTER  0x0004
+#define PCI_STATUS_CAP_LIST     0x0010
+
+#define PCI_CAP_ID_VENDOR  0x09
+
+typedef struct {
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t function;
+    uint16_t vendor_id;
+    uint16_t device_id;
+    uint8_t irq_line;
+} PciDevice;
+
+uint32_t pci_config_read32(const PciDevice* dev, uint8_t offset);
+uint16_t pci_config_read16(const PciDevice* dev, uint8_t offset);
+uint8_t pci_config_read8(const PciDevice* dev, uint8_t offset);
+void pci_config_write32(const PciDevice* dev, uint8_t offset, uint32_t value);
+void pci_config_write16(const PciDevice* dev, uint8_t offset, uint16_t value);
+
+// Scans every bus/slot/function; returns 1 and fills *out on the first match.
+int pci_find_device(uint16_t vendor_id, uint16_t device_id, PciDevice* out);
+
+// Decodes BAR n. Returns the I/O port or memory base (flags stripped);
+// *is_io reports the BAR kind. 64-bit BARs whose high half is non-zero
+// are unreachable without paging and yield 0.
+uint32_t pci_bar_address(const PciDevice* dev, int bar, uint8_t* is_io);
+
+// Size in bytes of memory BAR n (low 32 bits only), found by the usual
+// all-ones probe with decoding briefly disabled.
+uint32_t pci_bar_size(const PciDevice* dev, int bar);
+
+void pci_enable(const PciDevice* dev, uint16_t command_bits);
+
+#endif
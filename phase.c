@@ -0,0 +1,169 @@
+// phase.c
+
+#include "platform.h"
+#include "phase.h"
+
+typedef struct {
+    int stack[PHASE_MAX_DEPTH];
+    int depth;
+    uint64_t mark;                              // TSC at the last transition
+    uint64_t mark_events[PMU_EVENT_COUNT];      // PMU counters at the last transition
+    uint64_t generation_cycles[PHASE_COUNT];
+    uint64_t generation_events[PHASE_COUNT][PMU_EVENT_COUNT];
+    uint32_t generation_entries[PHASE_COUNT];
+    PhaseStats stats[PHASE_COUNT];
+} __attribute__((aligned(CACHE_LINE_SIZE))) PhaseState;   // One line-padded slot per CPU
+
+static PhaseState phase_state[MAX_CPUS];
+
+static const char* phase_names[PHASE_COUNT] = {
+    "vocab_hash", "ca_rules", "spawn", "alignment",
+    "gc_mark", "state_apply", "gc_compact", "render"
+};
+
+// Charges the cycles (and PMU events) since the last transition to the
+// innermost open phase
+static inline void phase_charge(PhaseState* state, uint64_t now) {
+    int phase = state->depth > 0 ? state->stack[state->depth - 1] : PHASE_NONE;
+    if (phase != PHASE_NONE) {
+        state->generation_cycles[phase] += now - state->mark;
+    }
+    state->mark = now;
+
+    if (!pmu_present()) return;
+    uint64_t events[PMU_EVENT_COUNT];
+    pmu_read(events);
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) {
+        if (phase != PHASE_NONE) {
+            state->generation_events[phase][event] += events[event] - state->mark_events[event];
+        }
+        state->mark_events[event] = events[event];
+    }
+}
+
+void phase_enter(int phase) {
+    PhaseState* state = &phase_state[cpu_index()];
+    phase_charge(state, rdtsc());
+    if (state->depth < PHASE_MAX_DEPTH) {
+        state->stack[state->depth++] = phase;
+    }
+    state->generation_entries[phase]++;
+}
+
+void phase_exit() {
+    PhaseState* state = &phase_state[cpu_index()];
+    phase_charge(state, rdtsc());
+    if (state->depth > 0) state->depth--;
+}
+
+int phase_current() {
+    PhaseState* state = &phase_state[cpu_index()];
+    return state->depth > 0 ? state->stack[state->depth - 1] : PHASE_NONE;
+}
+
+const char* phase_name(int phase) {
+    return (phase >= 0 && phase < PHASE_COUNT) ? phase_names[phase] : "none";
+}
+
+uint64_t phase_generation_cycles(int phase) {
+    return phase_state[cpu_index()].generation_cycles[phase];
+}
+
+void phase_end_generation() {
+    PhaseState* state = &phase_state[cpu_index()];
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        if (state->generation_entries[phase] == 0) continue;
+
+        uint64_t cycles = state->generation_cycles[phase];
+        PhaseStats* stats = &state->stats[phase];
+        if (stats->generations == 0 || cycles < stats->min_cycles) stats->min_cycles = cycles;
+        if (cycles > stats->max_cycles) stats->max_cycles = cycles;
+        stats->total_cycles += cycles;
+        stats->generations++;
+        stats->entries += state->generation_entries[phase];
+        for (int event = 0; event < PMU_EVENT_COUNT; event++) {
+            stats->events[event] += state->generation_events[phase][event];
+            state->generation_events[phase][event] = 0;
+        }
+
+        state->generation_cycles[phase] = 0;
+        state->generation_entries[phase] = 0;
+    }
+}
+
+const PhaseStats* phase_get_stats(int phase) {
+    return &phase_state[cpu_index()].stats[phase];
+}
+
+void phase_reset() {
+    memset(&phase_state[cpu_index()], 0, sizeof(PhaseState));
+}
+
+// numerator * scale / denominator with a 64-bit denominator
+static uint32_t scaled_ratio(uint64_t numerator, uint64_t denominator, uint32_t scale) {
+    while (denominator >> 32) {
+        numerator >>= 1;
+        denominator >>= 1;
+    }
+    if (denominator == 0) return 0;
+    return (uint32_t)div64_u32(numerator * scale, (uint32_t)denominator);
+}
+
+// IPC and misses per thousand instructions: a phase with low IPC and high
+// LLC MPKI is memory-bound, low IPC with few misses points at the core.
+static void phase_print_pmu_summary(PhaseState* state) {
+    serial_print("[STATS] phase ipc_x100 llc_mpki_x100 br_mpki_x100\n");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        PhaseStats* stats = &state->stats[phase];
+        if (stats->generations == 0) continue;
+
+        uint64_t cycles = stats->events[PMU_EVENT_CYCLES];
+        uint64_t instructions = stats->events[PMU_EVENT_INSTRUCTIONS];
+
+        serial_print("[STATS] ");
+        serial_print(phase_names[phase]);
+        for (int pad = strlen(phase_names[phase]); pad < 12; pad++) serial_print(" ");
+        serial_print(" ");
+        serial_print_dec(scaled_ratio(instructions, cycles, 100));
+        serial_print(" ");
+        serial_print_dec(scaled_ratio(stats->events[PMU_EVENT_LLC_MISSES], instructions, 100000));
+        serial_print(" ");
+        serial_print_dec(scaled_ratio(stats->events[PMU_EVENT_BRANCH_MISSES], instructions, 100000));
+        serial_print("\n");
+    }
+}
+
+void phase_print_summary() {
+    PhaseState* state = &phase_state[cpu_index()];
+    uint32_t all_kcycles = 0;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        all_kcycles += (uint32_t)(state->stats[phase].total_cycles >> 10);
+    }
+
+    serial_print("[STATS] phase gens avg_cycles min_cycles max_cycles share%\n");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        PhaseStats* stats = &state->stats[phase];
+        if (stats->generations == 0) continue;
+
+        uint32_t share = all_kcycles ?
+            (uint32_t)div64_u32((uint64_t)(uint32_t)(stats->total_cycles >> 10) * 100, all_kcycles) : 0;
+
+        serial_print("[STATS] ");
+        serial_print(phase_names[phase]);
+        for (int pad = strlen(phase_names[phase]); pad < 12; pad++) serial_print(" ");
+        serial_print(" ");
+        serial_print_dec(stats->generations);
+        serial_print(" ");
+        serial_print_dec64(div64_u32(stats->total_cycles, stats->generations));
+        serial_print(" ");
+        serial_print_dec64(stats->min_cycles);
+        serial_print(" ");
+        serial_print_dec64(stats->max_cycles);
+        serial_print(" ");
+        serial_print_dec(share);
+        serial_print("\n");
+    }
+
+    if (pmu_present()) phase_print_pmu_summary(state);
+}
@@ -0,0 +1,51 @@
+// phase.h
+// RDTSC phase timers for the generation pipeline.
+//
+// Phases nest (spawn runs inside CA rule evaluation); time is charged
+// exclusively to the innermost open phase. Each generation's per-phase sum
+// is folded into running totals, minima and maxima by phase_end_generation.
+// When the PMU is available the same exclusive attribution is applied to
+// the hardware events in pmu.h.
+
+#ifndef PHASE_H
+#define PHASE_H
+
+#include "platform.h"
+#include "pmu.h"
+
+#define PHASE_NONE          -1
+#define PHASE_VOCAB_HASH    0
+#define PHASE_CA_RULES      1
+#define PHASE_SPAWN         2
+#define PHASE_ALIGNMENT     3
+#define PHASE_GC_MARK       4
+#define PHASE_STATE_APPLY   5
+#define PHASE_GC_COMPACT    6
+#define PHASE_RENDER        7
+#define PHASE_COUNT         8
+
+#define PHASE_MAX_DEPTH     4
+
+typedef struct {
+    uint64_t total_cycles;      // Sum over all folded generations
+    uint64_t min_cycles;        // Cheapest generation
+    uint64_t max_cycles;        // Most expensive generation
+    uint32_t generations;       // Generations in which the phase ran
+    uint32_t entries;           // phase_enter calls
+    uint64_t events[PMU_EVENT_COUNT];   // PMU event totals (zero without a PMU)
+} PhaseStats;
+
+void phase_enter(int phase);
+void phase_exit();
+int phase_current();
+const char* phase_name(int phase);
+
+// Per-generation sum of a phase so far (for the current CPU).
+uint64_t phase_generation_cycles(int phase);
+
+void phase_end_generation();
+const PhaseStats* phase_get_stats(int phase);
+void phase_print_summary();
+void phase_reset();
+
+#endif
@@ -0,0 +1,98 @@
+// platform.h
+// Platform layer for the simulation core (holographic.c) and the
+// instrumentation it calls into (phase.c, hdr_histogram.c).
+//
+// Freestanding builds map straight onto kernel.h. Hosted builds take types
+// and memory/string helpers from libc, the cycle counter from RDTSC (or a
+// monotonic clock off x86), and the console from tools/platform_host.c.
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#if __STDC_HOSTED__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MAX_CPUS 1
+#define CACHE_LINE_SIZE 64
+
+static inline uint32_t cpu_index(void) {
+    return 0;
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void cpuid(uint32_t leaf, uint32_t subleaf,
+                         uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    __asm__ volatile("cpuid"
+                     : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                     : "a"(leaf), "c"(subleaf));
+}
+#else
+uint64_t platform_monotonic_ns(void);   // tools/platform_host.c
+
+static inline uint64_t rdtsc(void) {
+    return platform_monotonic_ns();
+}
+#endif
+
+static inline uint64_t div64_u32(uint64_t dividend, uint32_t divisor) {
+    return dividend / divisor;
+}
+
+static inline int platform_sse_usable(void) {
+#if defined(__SSE__)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static inline int platform_sse2_usable(void) {
+#if defined(__SSE2__)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// Console (tools/platform_host.c writes to stdout)
+void serial_print(const char* str);
+void serial_print_hex(uint32_t value);
+void serial_print_dec(uint32_t value);
+void serial_print_dec64(uint64_t value);
+void print(const char* str);
+void print_hex(uint32_t value);
+void console_set_muted(int muted);
+
+#else
+
+#include "kernel.h"
+
+// SSE instructions raise #UD until CR4.OSFXSR is set (sse_enable)
+static inline int platform_sse_usable(void) {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 25)) && (read_cr4() & CR4_OSFXSR);
+}
+
+static inline int platform_sse2_usable(void) {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 26)) && (read_cr4() & CR4_OSFXSR);
+}
+
+#endif
+
+static inline uint64_t platform_cycles(void) {
+    return rdtsc();
+}
+
+#endif
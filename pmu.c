@@ -0,0 +1,107 @@
+// pmu.c
+
+#include "kernel.h"
+#include "pmu.h"
+
+#define MSR_IA32_PMC0               0x0C1
+#define MSR_IA32_PERFEVTSEL0        0x186
+#define MSR_IA32_PERF_GLOBAL_CTRL   0x38F
+
+#define PERFEVTSEL_USR      (1u << 16)
+#define PERFEVTSEL_OS       (1u << 17)
+#define PERFEVTSEL_EN       (1u << 22)
+
+typedef struct {
+    const char* name;
+    uint8_t event_select;
+    uint8_t unit_mask;
+    uint8_t cpuid_bit;          // CPUID.0AH:EBX bit, set when NOT available
+} PmuEventInfo;
+
+static const PmuEventInfo pmu_events[PMU_EVENT_COUNT] = {
+    { "cycles",        0x3C, 0x00, 0 },
+    { "instructions",  0xC0, 0x00, 1 },
+    { "llc_misses",    0x2E, 0x41, 4 },
+    { "branch_misses", 0xC5, 0x00, 6 },
+};
+
+static int pmu_version = 0;
+static int pmu_counter_of[PMU_EVENT_COUNT];    // GP counter index, -1 if disabled
+static int pmu_enabled_events = 0;
+
+int pmu_init() {
+    uint32_t eax, ebx, ecx, edx;
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) pmu_counter_of[event] = -1;
+    pmu_enabled_events = 0;
+
+    cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+    if (eax < 0xA) {
+        serial_print("[PMU] CPUID leaf 0xA not supported, TSC only\n");
+        return 0;
+    }
+
+    cpuid(0xA, 0, &eax, &ebx, &ecx, &edx);
+    pmu_version = eax & 0xFF;
+    uint32_t counters = (eax >> 8) & 0xFF;
+    uint32_t width = (eax >> 16) & 0xFF;
+    uint32_t mask_length = (eax >> 24) & 0xFF;
+    if (pmu_version == 0 || counters == 0) {
+        serial_print("[PMU] No architectural PMU, TSC only\n");
+        return 0;
+    }
+
+    uint32_t global_enable = 0;
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) {
+        const PmuEventInfo* info = &pmu_events[event];
+        if (info->cpuid_bit >= mask_length || (ebx & (1u << info->cpuid_bit))) continue;
+        if ((uint32_t)pmu_enabled_events >= counters) break;
+
+        int counter = pmu_enabled_events++;
+        wrmsr(MSR_IA32_PERFEVTSEL0 + counter, 0);
+        wrmsr(MSR_IA32_PMC0 + counter, 0);
+        wrmsr(MSR_IA32_PERFEVTSEL0 + counter,
+              info->event_select | ((uint32_t)info->unit_mask << 8) |
+              PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_EN);
+        pmu_counter_of[event] = counter;
+        global_enable |= 1u << counter;
+    }
+
+    // Version 2 added a global enable that gates every counter
+    if (pmu_version >= 2 && global_enable) {
+        wrmsr(MSR_IA32_PERF_GLOBAL_CTRL, rdmsr(MSR_IA32_PERF_GLOBAL_CTRL) | global_enable);
+    }
+
+    serial_print("[PMU] version=");
+    serial_print_dec(pmu_version);
+    serial_print(" counters=");
+    serial_print_dec(counters);
+    serial_print(" width=");
+    serial_print_dec(width);
+    serial_print(" events=");
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) {
+        if (pmu_counter_of[event] < 0) continue;
+        serial_print(pmu_events[event].name);
+        serial_print(" ");
+    }
+    serial_print("\n");
+    return pmu_enabled_events;
+}
+
+int pmu_present() {
+    return pmu_enabled_events > 0;
+}
+
+int pmu_event_enabled(int event) {
+    return pmu_counter_of[event] >= 0;
+}
+
+const char* pmu_event_name(int event) {
+    return pmu_events[event].name;
+}
+
+void pmu_read(uint64_t values[PMU_EVENT_COUNT]) {
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) {
+        int counter = pmu_counter_of[event];
+        values[event] = counter >= 0 ? rdpmc(counter) : 0;
+    }
+}
@@ -0,0 +1,30 @@
+// pmu.h
+// Architectural performance monitoring (CPUID leaf 0xA).
+//
+// Programs one general-purpose counter per event below and reads them with
+// RDPMC. Events the CPU does not enumerate, or that exceed the number of
+// counters, read as zero. Without a PMU (QEMU TCG, AMD) every read is zero
+// and callers fall back to TSC-only accounting.
+
+#ifndef PMU_H
+#define PMU_H
+
+#include "platform.h"
+
+#define PMU_EVENT_CYCLES        0   // Unhalted core cycles
+#define PMU_EVENT_INSTRUCTIONS  1   // Instructions retired
+#define PMU_EVENT_LLC_MISSES    2   // Last-level cache misses
+#define PMU_EVENT_BRANCH_MISSES 3   // Mispredicted branches retired
+#define PMU_EVENT_COUNT         4
+
+// Detects and programs the counters. Returns the number of events counted
+// (0 when the PMU is absent).
+int pmu_init();
+int pmu_present();
+int pmu_event_enabled(int event);
+const char* pmu_event_name(int event);
+
+// Current raw value of every event; disabled events read as 0.
+void pmu_read(uint64_t values[PMU_EVENT_COUNT]);
+
+#endif
@@ -0,0 +1,100 @@
+// prefetch.c
+// Cache-size detection and look-ahead selection for the pool scans.
+
+#include "platform.h"
+#include "prefetch.h"
+
+uint32_t prefetch_distance = 0;
+
+static uint32_t line_bytes = CACHE_LINE_SIZE;
+static uint32_t l1d_bytes = 0;
+static uint32_t llc_bytes = 0;
+
+#if defined(__i386__) || defined(__x86_64__)
+static void detect_caches() {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+
+    // Deterministic cache parameters: one subleaf per cache, type 0 ends
+    // the list. Levels come in increasing order, so the last data or
+    // unified cache seen is the last level.
+    for (uint32_t index = 0; eax >= 4 && index < 8; index++) {
+        uint32_t a, b, c, d;
+        cpuid(4, index, &a, &b, &c, &d);
+        uint32_t type = a & 0x1F;
+        if (type == 0) break;
+        if (type == 2) continue;                    // Instruction cache
+        uint32_t line = (b & 0xFFF) + 1;
+        uint32_t bytes = ((b >> 22) + 1) * (((b >> 12) & 0x3FF) + 1) * line * (c + 1);
+        if (((a >> 5) & 7) == 1) {
+            l1d_bytes = bytes;
+            line_bytes = line;
+        }
+        llc_bytes = bytes;
+    }
+
+    // AMD (and anything without leaf 4): L1d in 0x80000005, L2/L3 in 0x80000006
+    cpuid(0x80000000, 0, &eax, &ebx, &ecx, &edx);
+    uint32_t max_extended = eax;
+    if (l1d_bytes == 0 && max_extended >= 0x80000005) {
+        cpuid(0x80000005, 0, &eax, &ebx, &ecx, &edx);
+        l1d_bytes = (ecx >> 24) << 10;
+        if (ecx & 0xFF) line_bytes = ecx & 0xFF;
+    }
+    if (llc_bytes == 0 && max_extended >= 0x80000006) {
+        cpuid(0x80000006, 0, &eax, &ebx, &ecx, &edx);
+        llc_bytes = (ecx >> 16) << 10;
+        if ((edx >> 18) != 0) llc_bytes = (edx >> 18) << 19;
+    }
+}
+#endif
+
+void prefetch_init() {
+#if defined(__i386__) || defined(__x86_64__)
+    detect_caches();
+#endif
+    if (line_bytes < 16 || (line_bytes & (line_bytes - 1)) != 0) {
+        line_bytes = CACHE_LINE_SIZE;
+    }
+
+    // Enough lines in flight to cover memory latency, but never more than
+    // an eighth of L1d, which the scan's own loads still need
+    prefetch_distance = line_bytes * PREFETCH_LINES_AHEAD;
+    if (l1d_bytes && prefetch_distance > l1d_bytes / 8) {
+        prefetch_distance = l1d_bytes / 8;
+    }
+#if !__STDC_HOSTED__
+    // PREFETCHh arrived with SSE
+    if (!platform_sse_usable()) prefetch_distance = 0;
+#endif
+
+    serial_print("[PREFETCH] line=");
+    serial_print_dec(line_bytes);
+    serial_print(" l1d=");
+    serial_print_dec(l1d_bytes);
+    serial_print(" llc=");
+    serial_print_dec(llc_bytes);
+    serial_print(" distance=");
+    serial_print_dec(prefetch_distance);
+    serial_print("\n");
+}
+
+uint32_t prefetch_line_bytes() {
+    return line_bytes;
+}
+
+uint32_t prefetch_llc_bytes() {
+    return llc_bytes;
+}
+
+// Half the LLC leaves room for everything else the generation touches
+int prefetch_hint_for(uint32_t bytes) {
+    return (llc_bytes && bytes > llc_bytes / 2) ? PREFETCH_NTA : PREFETCH_T0;
+}
+
+void prefetch_range(const void* address, uint32_t bytes, int hint) {
+    const char* line = (const char*)address;
+    for (uint32_t offset = 0; offset < bytes; offset += line_bytes) {
+        prefetch(line + offset, hint);
+    }
+}
@@ -0,0 +1,56 @@
+// prefetch.h
+// Software prefetch for the linear pool scans (retrieve, top-k, entity
+// update and render).
+//
+// prefetch_init reads the cache hierarchy from CPUID (leaf 4 on Intel,
+// 0x80000005/6 on AMD) and sets the look-ahead distance from the L1d line
+// size. Scans ask prefetch_hint_for() how to fetch: a scan whose total
+// footprint fits in half the last-level cache uses PREFETCHT0; larger ones
+// stream through with PREFETCHNTA so they don't flush the working set.
+// In the kernel prefetching stays off on CPUs without SSE.
+
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include "platform.h"
+
+#define PREFETCH_T0     0
+#define PREFETCH_NTA    1
+
+#define PREFETCH_LINES_AHEAD    8       // Default look-ahead, in L1d lines
+#define PREFETCH_DISTANCE_MAX   4096
+
+// Bytes the scans fetch ahead of the element they are working on; 0 turns
+// software prefetch off. Runtime tunable in the kernel.
+extern uint32_t prefetch_distance;
+
+// Detects the cache sizes, picks the distance and logs both. Any scan
+// before it runs with prefetching off.
+void prefetch_init();
+uint32_t prefetch_line_bytes();
+uint32_t prefetch_llc_bytes();
+
+// PREFETCH_NTA when a scan over `bytes` would not fit in the last-level
+// cache, PREFETCH_T0 otherwise
+int prefetch_hint_for(uint32_t bytes);
+
+static inline void prefetch(const void* address, int hint) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (hint == PREFETCH_NTA) {
+        __asm__ volatile("prefetchnta %0" :: "m"(*(const char*)address));
+    } else {
+        __asm__ volatile("prefetcht0 %0" :: "m"(*(const char*)address));
+    }
+#else
+    if (hint == PREFETCH_NTA) {
+        __builtin_prefetch(address, 0, 0);
+    } else {
+        __builtin_prefetch(address, 0, 3);
+    }
+#endif
+}
+
+// Every line of [address, address + bytes)
+void prefetch_range(const void* address, uint32_t bytes, int hint);
+
+#endif
@@ -0,0 +1,134 @@
+// profiler.c
+
+#include "kernel.h"
+#include "idt.h"
+#include "timer.h"
+#include "profiler.h"
+
+typedef struct {
+    uint32_t frames[PROFILER_STACK_DEPTH];
+    uint32_t count;
+} ProfileSlot;
+
+typedef struct {
+    ProfileSlot slots[PROFILER_SLOTS];
+    uint32_t samples;
+    uint32_t dropped;       // Table full
+    uint32_t used;
+} __attribute__((aligned(CACHE_LINE_SIZE))) ProfileHistogram;
+
+static ProfileHistogram histograms[MAX_CPUS];
+static volatile uint8_t profiling = 0;
+static volatile uint8_t dumping = 0;
+
+void profiler_start() {
+    profiling = 1;
+}
+
+void profiler_stop() {
+    profiling = 0;
+}
+
+int profiler_running() {
+    return profiling;
+}
+
+void profiler_reset() {
+    uint32_t flags = interrupts_save_disable();
+    memset(&histograms[cpu_index()], 0, sizeof(ProfileHistogram));
+    interrupts_restore(flags);
+}
+
+// Walks saved-EBP links of the interrupted code. Frames must sit between the
+// interrupted ESP and the stack top and strictly ascend, which rejects garbage
+// EBP values in leaf code that uses it as a general register.
+static void capture_stack(const InterruptFrame* frame, uint32_t* frames) {
+    uint32_t low = interrupt_frame_esp(frame);
+    uint32_t ebp = frame->ebp;
+
+    frames[0] = frame->eip;
+    for (int depth = 1; depth < PROFILER_STACK_DEPTH; depth++) {
+        if (ebp < low || ebp + 8 > KERNEL_STACK_TOP || (ebp & 3)) {
+            frames[depth] = 0;
+            continue;
+        }
+        uint32_t* link = (uint32_t*)ebp;
+        frames[depth] = link[1];
+        low = ebp + 8;
+        ebp = link[0];
+    }
+}
+
+void profiler_sample(InterruptFrame* frame) {
+    if (!profiling || dumping) return;
+
+    ProfileHistogram* histogram = &histograms[cpu_index()];
+    uint32_t frames[PROFILER_STACK_DEPTH];
+    capture_stack(frame, frames);
+    histogram->samples++;
+
+    uint32_t hash = 2166136261U;
+    for (int i = 0; i < PROFILER_STACK_DEPTH; i++) {
+        hash = (hash ^ frames[i]) * 16777619U;
+    }
+
+    // Open addressing with linear probing; bounded so a full table stays O(1)
+    for (int probe = 0; probe < 16; probe++) {
+        ProfileSlot* slot = &histogram->slots[(hash + probe) & (PROFILER_SLOTS - 1)];
+        if (slot->count == 0) {
+            for (int i = 0; i < PROFILER_STACK_DEPTH; i++) slot->frames[i] = frames[i];
+            slot->count = 1;
+            histogram->used++;
+            return;
+        }
+        int same = 1;
+        for (int i = 0; i < PROFILER_STACK_DEPTH; i++) {
+            if (slot->frames[i] != frames[i]) {
+                same = 0;
+                break;
+            }
+        }
+        if (same) {
+            slot->count++;
+            return;
+        }
+    }
+    histogram->dropped++;
+}
+
+void profiler_dump() {
+    // Sampling pauses while the (slow) serial dump runs so the table is stable
+    dumping = 1;
+    barrier();
+
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        ProfileHistogram* histogram = &histograms[cpu];
+        serial_print("[PROF] BEGIN cpu=");
+        serial_print_dec(cpu);
+        serial_print(" hz=");
+        serial_print_dec(timer_hz());
+        serial_print(" samples=");
+        serial_print_dec(histogram->samples);
+        serial_print(" dropped=");
+        serial_print_dec(histogram->dropped);
+        serial_print(" stacks=");
+        serial_print_dec(histogram->used);
+        serial_print("\n");
+
+        for (int i = 0; i < PROFILER_SLOTS; i++) {
+            ProfileSlot* slot = &histogram->slots[i];
+            if (slot->count == 0) continue;
+            serial_print("[PROF] ");
+            serial_print_dec(slot->count);
+            for (int depth = 0; depth < PROFILER_STACK_DEPTH && slot->frames[depth]; depth++) {
+                serial_print(" ");
+                serial_print_hex(slot->frames[depth]);
+            }
+            serial_print("\n");
+        }
+        serial_print("[PROF] END\n");
+    }
+
+    barrier();
+    dumping = 0;
+}
@@ -0,0 +1,29 @@
+// profiler.h
+// Statistical profiler fed by the timer interrupt.
+//
+// Each tick records the interrupted EIP plus a short frame-pointer backtrace
+// into the current CPU's histogram. profiler_dump() prints the histogram over
+// serial as "[PROF]" lines; tools/symbolize_profile.py resolves them against
+// kernel.elf into a flat profile and folded stacks.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "kernel.h"
+#include "idt.h"
+
+#define PROFILER_STACK_DEPTH   4        // Interrupted EIP + 3 return addresses
+#define PROFILER_SLOTS         2048     // Distinct stacks per CPU, power of two
+#define PROFILER_DUMP_INTERVAL 128      // Generations between automatic dumps
+
+void profiler_start();
+void profiler_stop();
+void profiler_reset();
+int profiler_running();
+
+// Called from the timer interrupt.
+void profiler_sample(InterruptFrame* frame);
+
+void profiler_dump();
+
+#endif
@@ -0,0 +1,295 @@
+// replay.c
+// Log format: a header sector followed by a byte stream of events, each
+//   kind (1 byte) | varint(generation delta) | varint(zigzag(value delta))
+// where deltas are taken against the previous event (generation) and the
+// previous event of the same kind (value). Timestamps advance by roughly
+// update_interval per generation, so most events fit in 4-6 bytes.
+
+#include "kernel.h"
+#include "holographic.h"
+#include "virtio_blk.h"
+#include "replay.h"
+
+#define REPLAY_MAGIC        "HOLOREPL"
+#define REPLAY_VERSION      1
+#define REPLAY_EVENT_KINDS  5
+#define REPLAY_MAX_EVENT    11   // kind + two 5-byte varints
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t length;          // Encoded event bytes
+    uint32_t events;
+    uint32_t generations;
+    uint32_t log_hash;
+    uint32_t truncated;
+} ReplayLogHeader;
+
+struct ReplayState {
+    int mode;
+    uint32_t length;          // Record: bytes written; replay: bytes loaded
+    uint32_t cursor;          // Replay read position
+    uint32_t events;
+    uint32_t generations;
+    uint32_t generation;      // Generation currently executing
+    uint32_t last_event_generation;
+    uint32_t last_value[REPLAY_EVENT_KINDS];
+    uint8_t truncated;
+    uint8_t diverged;
+    uint32_t checks_passed;
+    uint32_t verified_generation;   // Last generation whose state hash matched
+    uint64_t start_cycles;
+};
+
+static struct ReplayState replay_state;
+static uint8_t replay_log[REPLAY_LOG_BYTES] __attribute__((aligned(16)));
+static uint8_t replay_header_sector[VIRTIO_BLK_SECTOR_SIZE] __attribute__((aligned(16)));
+
+//---Encoding helpers---
+static uint32_t put_varint(uint8_t* out, uint32_t value) {
+    uint32_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static int get_varint(uint32_t* value) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (replay_state.cursor >= replay_state.length) return 0;
+        uint8_t byte = replay_log[replay_state.cursor++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static uint32_t replay_state_hash() {
+    uint32_t hash = holographic_entity_state_hash();
+    hash ^= active_entity_count * 2654435761U;
+    hash ^= holo_system.memory_count * 40503U;
+    return hash;
+}
+
+//---Record path---
+static void record_event(uint8_t kind, uint32_t value) {
+    if (replay_state.truncated) return;
+    if (replay_state.length + REPLAY_MAX_EVENT > REPLAY_LOG_BYTES) {
+        replay_state.truncated = 1;
+        serial_print("[REPLAY] Log full, recording stopped at generation ");
+        serial_print_dec(replay_state.generation);
+        serial_print("\n");
+        return;
+    }
+
+    uint8_t* out = &replay_log[replay_state.length];
+    uint32_t n = 0;
+    out[n++] = kind;
+    n += put_varint(out + n, replay_state.generation - replay_state.last_event_generation);
+    n += put_varint(out + n, zigzag((int32_t)(value - replay_state.last_value[kind])));
+
+    replay_state.length += n;
+    replay_state.events++;
+    replay_state.last_event_generation = replay_state.generation;
+    replay_state.last_value[kind] = value;
+}
+
+//---Replay path---
+// Halts: carrying on live would let the next checkpoint_save overwrite the
+// snapshot the replay started from and leave nothing to investigate. The
+// first divergence lies after the last verified generation.
+static void replay_diverged(const char* why) {
+    replay_state.diverged = 1;
+    replay_state.mode = REPLAY_MODE_OFF;
+    console_set_muted(0);
+    serial_print("[REPLAY] DIVERGED at generation ");
+    serial_print_dec(replay_state.generation);
+    serial_print(" (state last verified at generation ");
+    serial_print_dec(replay_state.verified_generation);
+    serial_print("): ");
+    serial_print(why);
+    serial_print("\n");
+    serial_print("[REPLAY] Halted; checkpoint and replay log left as they are.\n");
+    __asm__ volatile("cli");
+    while (1) __asm__ volatile("hlt");
+}
+
+static uint32_t replay_next_event(uint8_t kind, uint32_t live_value) {
+    if (replay_state.cursor >= replay_state.length) {
+        replay_diverged("log exhausted");
+        return live_value;
+    }
+
+    uint8_t logged_kind = replay_log[replay_state.cursor++];
+    uint32_t generation_delta, value_delta;
+    if (logged_kind != kind || logged_kind >= REPLAY_EVENT_KINDS ||
+        !get_varint(&generation_delta) || !get_varint(&value_delta)) {
+        replay_diverged("unexpected input kind");
+        return live_value;
+    }
+
+    uint32_t logged_generation = replay_state.last_event_generation + generation_delta;
+    if (logged_generation != replay_state.generation) {
+        replay_diverged("input consumed in the wrong generation");
+        return live_value;
+    }
+
+    uint32_t value = replay_state.last_value[kind] + (uint32_t)unzigzag(value_delta);
+    replay_state.last_event_generation = logged_generation;
+    replay_state.last_value[kind] = value;
+    replay_state.events++;
+    return value;
+}
+
+static int replay_load() {
+    if (!virtio_blk_present() ||
+        virtio_blk_read(REPLAY_LOG_LBA, replay_header_sector, 1) != 0) {
+        serial_print("[REPLAY] No disk to replay from.\n");
+        return 0;
+    }
+
+    ReplayLogHeader header;
+    memcpy(&header, replay_header_sector, sizeof(header));
+    for (int i = 0; i < 8; i++) {
+        if (header.magic[i] != REPLAY_MAGIC[i]) {
+            serial_print("[REPLAY] No replay log on disk.\n");
+            return 0;
+        }
+    }
+    if (header.version != REPLAY_VERSION || header.length > REPLAY_LOG_BYTES) {
+        serial_print("[REPLAY] Replay log format not supported.\n");
+        return 0;
+    }
+
+    uint32_t sectors = (header.length + VIRTIO_BLK_SECTOR_SIZE - 1) / VIRTIO_BLK_SECTOR_SIZE;
+    if (sectors && virtio_blk_read(REPLAY_LOG_LBA + 1, replay_log, sectors) != 0) return 0;
+    if (hash_data(replay_log, header.length) != header.log_hash) {
+        serial_print("[REPLAY] Replay log is corrupt.\n");
+        return 0;
+    }
+
+    replay_state.length = header.length;
+    replay_state.generations = header.generations;
+    serial_print("[REPLAY] Replaying ");
+    serial_print_dec(header.generations);
+    serial_print(" generations (");
+    serial_print_dec(header.events);
+    serial_print(" events, ");
+    serial_print_dec(header.length);
+    serial_print(" bytes), console muted.\n");
+    return 1;
+}
+
+//---Public interface---
+int replay_init(int restored_from_checkpoint) {
+    memset(&replay_state, 0, sizeof(replay_state));
+    replay_state.mode = REPLAY_MODE;
+
+    if (replay_state.mode == REPLAY_MODE_RECORD && restored_from_checkpoint) {
+        serial_print("[REPLAY] Recording disabled: run resumed from a checkpoint.\n");
+        replay_state.mode = REPLAY_MODE_OFF;
+    } else if (replay_state.mode == REPLAY_MODE_RECORD) {
+        serial_print("[REPLAY] Recording nondeterministic inputs.\n");
+    } else if (replay_state.mode == REPLAY_MODE_REPLAY) {
+        if (replay_load()) {
+            console_set_muted(1);
+            replay_state.start_cycles = rdtsc();
+        } else {
+            replay_state.mode = REPLAY_MODE_OFF;
+        }
+    }
+    return replay_state.mode;
+}
+
+int replay_is_replaying() {
+    return replay_state.mode == REPLAY_MODE_REPLAY;
+}
+
+void replay_begin_generation(uint32_t generation) {
+    replay_state.generation = generation;
+    if (replay_state.mode == REPLAY_MODE_RECORD && !replay_state.truncated) {
+        replay_state.generations = generation + 1;
+    }
+}
+
+uint32_t replay_input(uint8_t kind, uint32_t live_value) {
+    if (replay_state.mode == REPLAY_MODE_RECORD) {
+        record_event(kind, live_value);
+        return live_value;
+    }
+    if (replay_state.mode == REPLAY_MODE_REPLAY) {
+        return replay_next_event(kind, live_value);
+    }
+    return live_value;
+}
+
+void replay_check_state(uint32_t generation) {
+    if (replay_state.mode == REPLAY_MODE_OFF || generation % REPLAY_CHECK_INTERVAL != 0) return;
+
+    uint32_t live_hash = replay_state_hash();
+    uint32_t expected = replay_input(REPLAY_EVENT_STATE_HASH, live_hash);
+    if (replay_state.mode == REPLAY_MODE_REPLAY) {
+        if (expected != live_hash) {
+            replay_diverged("state hash mismatch");
+        } else {
+            replay_state.checks_passed++;
+            replay_state.verified_generation = generation;
+        }
+    }
+}
+
+int replay_finished() {
+    if (replay_state.mode != REPLAY_MODE_REPLAY || replay_state.cursor < replay_state.length) {
+        return 0;
+    }
+
+    uint64_t cycles = rdtsc() - replay_state.start_cycles;
+    console_set_muted(0);
+    serial_print("[REPLAY] Complete: ");
+    serial_print_dec(replay_state.generations);
+    serial_print(" generations in ");
+    serial_print_dec((uint32_t)(cycles >> 10));
+    serial_print(" Kcycles, ");
+    serial_print_dec(replay_state.checks_passed);
+    serial_print(" state checks passed, final hash ");
+    serial_print_hex(replay_state_hash());
+    serial_print("\n");
+    replay_state.mode = REPLAY_MODE_OFF;
+    return 1;
+}
+
+int replay_flush() {
+    if (replay_state.mode != REPLAY_MODE_RECORD || !virtio_blk_present()) return 0;
+
+    uint32_t sectors = (replay_state.length + VIRTIO_BLK_SECTOR_SIZE - 1) / VIRTIO_BLK_SECTOR_SIZE;
+    if (REPLAY_LOG_LBA + 1 + sectors > virtio_blk_capacity()) return 0;
+
+    ReplayLogHeader* header = (ReplayLogHeader*)replay_header_sector;
+    memset(replay_header_sector, 0, sizeof(replay_header_sector));
+    memcpy(header->magic, REPLAY_MAGIC, 8);
+    header->version = REPLAY_VERSION;
+    header->length = replay_state.length;
+    header->events = replay_state.events;
+    header->generations = replay_state.generations;
+    header->log_hash = hash_data(replay_log, replay_state.length);
+    header->truncated = replay_state.truncated;
+
+    // Tail bytes past `length` are stale but excluded from log_hash
+    if (sectors && virtio_blk_write(REPLAY_LOG_LBA + 1, replay_log, sectors) != 0) return 0;
+    if (virtio_blk_write(REPLAY_LOG_LBA, replay_header_sector, 1) != 0) return 0;
+    return virtio_blk_flush() == 0;
+}
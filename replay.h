@@ -0,0 +1,54 @@
+// replay.h
+// Deterministic record/replay of emergence runs.
+//
+// Everything update_entities consumes that does not follow from the initial
+// pools (the loop's timer-driven timestamp, task arrivals, the starting
+// timestamp) passes through replay_input(). Recording appends each value to
+// a compact log that is persisted next to the checkpoint; replaying feeds
+// the logged values back in order with rendering and console output muted.
+// A replay that diverges from the log reports it and halts the machine,
+// leaving the checkpoint and the log on disk untouched:
+//   [REPLAY] DIVERGED at generation <n> (state last verified at generation <n>): <why>
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "kernel.h"
+
+#define REPLAY_MODE_OFF     0
+#define REPLAY_MODE_RECORD  1
+#define REPLAY_MODE_REPLAY  2
+
+#ifndef REPLAY_MODE
+#define REPLAY_MODE REPLAY_MODE_RECORD
+#endif
+
+#define REPLAY_LOG_BYTES      65536
+#define REPLAY_LOG_LBA        8192      // 4 MB into the checkpoint disk; checkpoints end before it
+#define REPLAY_CHECK_INTERVAL 16        // Generations between state hashes
+
+// Input kinds
+#define REPLAY_EVENT_SEED       1   // Timestamp on entering the emergence loop
+#define REPLAY_EVENT_TIMESTAMP  2   // Timestamp at the start of a generation
+#define REPLAY_EVENT_TASK       3   // Task arrival: (entity index << 16) | path id
+#define REPLAY_EVENT_STATE_HASH 4   // Verification point, not an input
+
+// Record mode needs a fresh boot (no restored checkpoint); replay mode
+// loads the log from disk and mutes the console. Returns the active mode.
+int replay_init(int restored_from_checkpoint);
+int replay_is_replaying();
+
+void replay_begin_generation(uint32_t generation);
+uint32_t replay_input(uint8_t kind, uint32_t live_value);
+
+// Records or verifies a hash of the pools every REPLAY_CHECK_INTERVAL
+// generations.
+void replay_check_state(uint32_t generation);
+
+// Replay: 1 once every logged generation has run (the summary is printed).
+int replay_finished();
+
+// Record: persists the log to disk. Returns 1 on success.
+int replay_flush();
+
+#endif
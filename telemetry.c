@@ -0,0 +1,142 @@
+// telemetry.c
+// Single-writer publisher for the ivshmem telemetry region. The kernel never
+// waits on readers; the host side copes with concurrent updates using the
+// seqlock and per-record sequence numbers described in telemetry.h.
+
+#include "kernel.h"
+#include "holographic.h"
+#include "ivshmem.h"
+#include "telemetry.h"
+
+#define TELEMETRY_ALIGN(x) (((x) + 63) & ~63U)
+
+static TelemetryHeader* telemetry_region = NULL;
+static TelemetryTraceRing* trace_ring = NULL;
+static TelemetryTraceRecord* trace_records = NULL;
+
+// Accumulated between publishes; folded into the counters block each generation
+static uint32_t current_generation = 0;
+static uint32_t pending_spawns = 0;
+static uint32_t pending_collections = 0;
+static uint32_t total_spawns = 0;
+static uint32_t total_collections = 0;
+
+int telemetry_init() {
+    uint32_t base, size;
+    if (!ivshmem_init(&base, &size)) return 0;
+
+    uint32_t offset = TELEMETRY_ALIGN(sizeof(TelemetryHeader));
+    uint32_t column_bytes = TELEMETRY_ALIGN(MAX_ENTITIES * sizeof(uint32_t));
+    uint32_t layout_end = offset + 8 * column_bytes +
+                          TELEMETRY_ALIGN(sizeof(TelemetryTraceRing)) +
+                          TELEMETRY_TRACE_CAPACITY * sizeof(TelemetryTraceRecord);
+    if (layout_end > size) {
+        serial_print("[TELEMETRY] Shared region too small, need ");
+        serial_print_dec(layout_end);
+        serial_print(" bytes\n");
+        return 0;
+    }
+
+    TelemetryHeader* header = (TelemetryHeader*)base;
+    memset(header, 0, layout_end);
+
+    header->region_size = size;
+    header->pop_capacity = MAX_ENTITIES;
+    header->col_id = offset;             offset += column_bytes;
+    header->col_is_active = offset;      offset += column_bytes;
+    header->col_age = offset;            offset += column_bytes;
+    header->col_fitness = offset;        offset += column_bytes;
+    header->col_interactions = offset;   offset += column_bytes;
+    header->col_spawn_count = offset;    offset += column_bytes;
+    header->col_path_id = offset;        offset += column_bytes;
+    header->col_task_alignment = offset; offset += column_bytes;
+
+    header->trace_ring_count = 1;
+    header->trace_rings_offset = offset;
+    trace_ring = (TelemetryTraceRing*)(base + offset);
+    offset += TELEMETRY_ALIGN(sizeof(TelemetryTraceRing));
+    trace_ring->capacity = TELEMETRY_TRACE_CAPACITY;
+    trace_ring->records_offset = offset;
+    trace_records = (TelemetryTraceRecord*)(base + offset);
+
+    // Magic goes last: readers ignore the region until it is fully laid out
+    header->version = TELEMETRY_VERSION;
+    barrier();
+    header->magic = TELEMETRY_MAGIC;
+    telemetry_region = header;
+
+    serial_print("[TELEMETRY] Live telemetry exported over ivshmem.\n");
+    return 1;
+}
+
+void telemetry_trace(uint16_t kind, uint32_t subject, uint32_t arg) {
+    if (kind == TRACE_SPAWN) pending_spawns++;
+    if (kind == TRACE_GC_COLLECT) pending_collections++;
+    if (!telemetry_region) return;
+
+    uint32_t position = trace_ring->head;
+    TelemetryTraceRecord* record = &trace_records[position & (TELEMETRY_TRACE_CAPACITY - 1)];
+
+    record->seq = 0;
+    barrier();
+    record->generation = current_generation;
+    record->timestamp = holo_system.global_timestamp;
+    record->kind = kind;
+    record->subject = subject;
+    record->arg = arg;
+    barrier();
+    record->seq = position + 1;
+    barrier();
+    trace_ring->head = position + 1;
+}
+
+#define COLUMN(type, name) ((type*)((uint8_t*)telemetry_region + telemetry_region->name))
+
+void telemetry_publish_generation(uint32_t generation, uint64_t generation_cycles) {
+    total_spawns += pending_spawns;
+    total_collections += pending_collections;
+    current_generation = generation + 1;
+
+    if (telemetry_region) {
+        TelemetryCounters* counters = &telemetry_region->counters;
+        uint32_t awake = 0, mutants = 0, fitness = 0;
+
+        telemetry_region->seq++;
+        barrier();
+
+        for (uint32_t i = 0; i < active_entity_count; i++) {
+            struct Entity* entity = &entity_pool[i];
+            COLUMN(uint32_t, col_id)[i] = entity->id;
+            COLUMN(uint8_t, col_is_active)[i] = entity->is_active;
+            COLUMN(uint32_t, col_age)[i] = entity->age;
+            COLUMN(uint32_t, col_fitness)[i] = entity->fitness_score;
+            COLUMN(uint32_t, col_interactions)[i] = entity->interaction_count;
+            COLUMN(uint32_t, col_spawn_count)[i] = entity->spawn_count;
+            COLUMN(uint32_t, col_path_id)[i] = entity->path_id;
+            COLUMN(float, col_task_alignment)[i] = holo_alignment_to_float(entity->task_alignment);
+            awake += entity->is_active;
+            mutants += entity->is_mutant;
+            fitness += entity->fitness_score;
+        }
+
+        counters->generation = generation;
+        counters->global_timestamp = holo_system.global_timestamp;
+        counters->active_entities = active_entity_count;
+        counters->awake_entities = awake;
+        counters->mutant_entities = mutants;
+        counters->memory_count = holo_system.memory_count;
+        counters->generation_spawns = pending_spawns;
+        counters->generation_collections = pending_collections;
+        counters->total_spawns = total_spawns;
+        counters->total_collections = total_collections;
+        counters->total_fitness = fitness;
+        counters->last_generation_cycles_lo = (uint32_t)generation_cycles;
+        counters->last_generation_cycles_hi = (uint32_t)(generation_cycles >> 32);
+
+        barrier();
+        telemetry_region->seq++;
+    }
+
+    pending_spawns = 0;
+    pending_collections = 0;
+}
@@ -0,0 +1,102 @@
+// telemetry.h
+// Layout of the live telemetry region published through ivshmem.
+// Shared verbatim by the kernel (writer) and host tools (readers).
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#if __STDC_HOSTED__
+#include <stdint.h>
+#else
+#include "kernel.h"
+#endif
+
+#define TELEMETRY_MAGIC     0x4D4C5448U   // "HTLM"
+#define TELEMETRY_VERSION   1
+
+#define TELEMETRY_TRACE_CAPACITY 1024     // Records per ring, power of two
+
+// Trace event kinds
+#define TRACE_ACTIVATE   1   // subject activated by neighbor
+#define TRACE_SLEEP      2   // subject went dormant
+#define TRACE_SPAWN      3   // subject spawned by arg (parent id)
+#define TRACE_FITNESS    4   // subject alignment high, arg = new fitness
+#define TRACE_GC_MARK    5   // subject marked for collection
+#define TRACE_GC_COLLECT 6   // subject collected
+#define TRACE_FREEZE     7   // subject moved to the cold store, arg = record bytes
+#define TRACE_THAW       8   // subject brought back from the cold store
+
+// Counters and the population snapshot are guarded by a seqlock: the writer
+// makes `seq` odd before touching them and even afterwards. Readers copy,
+// then retry if `seq` was odd or changed. Trace records are validated per
+// record: `seq` is written last and equals the record's ring position + 1.
+typedef struct {
+    uint32_t seq;
+    uint32_t generation;
+    uint32_t timestamp;
+    uint16_t kind;
+    uint16_t reserved;
+    uint32_t subject;
+    uint32_t arg;
+} TelemetryTraceRecord;
+
+typedef struct {
+    uint32_t head;          // Total records ever written
+    uint32_t capacity;
+    uint32_t records_offset;
+    uint32_t reserved;
+} TelemetryTraceRing;
+
+typedef struct {
+    uint32_t generation;
+    uint32_t global_timestamp;
+    uint32_t active_entities;       // Population size
+    uint32_t awake_entities;        // is_active set
+    uint32_t mutant_entities;
+    uint32_t memory_count;
+    uint32_t generation_spawns;
+    uint32_t generation_collections;
+    uint32_t total_spawns;
+    uint32_t total_collections;
+    uint32_t total_fitness;
+    uint32_t last_generation_cycles_lo;
+    uint32_t last_generation_cycles_hi;
+} TelemetryCounters;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t region_size;
+    uint32_t seq;
+
+    TelemetryCounters counters;
+
+    // Population snapshot: one column per field, pop_capacity rows each,
+    // at byte offsets from the start of the region. Rows [0, active_entities)
+    // are valid.
+    uint32_t pop_capacity;
+    uint32_t col_id;
+    uint32_t col_is_active;         // uint8_t
+    uint32_t col_age;
+    uint32_t col_fitness;
+    uint32_t col_interactions;
+    uint32_t col_spawn_count;
+    uint32_t col_path_id;
+    uint32_t col_task_alignment;    // float
+
+    uint32_t trace_ring_count;
+    uint32_t trace_rings_offset;    // TelemetryTraceRing[trace_ring_count]
+} TelemetryHeader;
+
+#if !__STDC_HOSTED__
+// Kernel writer API (telemetry.c). Every call is a no-op when no ivshmem
+// device was found.
+int telemetry_init();
+void telemetry_publish_generation(uint32_t generation, uint64_t generation_cycles);
+#endif
+
+// Called from the simulation core; hosted builds of the core link the no-op
+// in tools/platform_host.c.
+void telemetry_trace(uint16_t kind, uint32_t subject, uint32_t arg);
+
+#endif
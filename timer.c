@@ -0,0 +1,38 @@
+// timer.c
+
+#include "kernel.h"
+#include "idt.h"
+#include "timer.h"
+#include "profiler.h"
+#include "watchdog.h"
+
+#define PIT_CHANNEL0 0x40
+#define PIT_COMMAND  0x43
+
+static volatile uint32_t tick_count = 0;
+static uint32_t tick_hz = 0;
+
+static void timer_interrupt(InterruptFrame* frame) {
+    tick_count++;
+    profiler_sample(frame);
+    watchdog_tick(tick_count);
+}
+
+void timer_init(uint32_t hz) {
+    uint32_t divisor = PIT_BASE_FREQUENCY / hz;
+    if (divisor > 0xFFFF) divisor = 0xFFFF;
+    tick_hz = PIT_BASE_FREQUENCY / divisor;
+
+    outb(PIT_COMMAND, 0x36);    // Channel 0, lo/hi byte, mode 3 (square wave)
+    outb(PIT_CHANNEL0, divisor & 0xFF);
+    outb(PIT_CHANNEL0, divisor >> 8);
+    irq_register(IRQ_TIMER, timer_interrupt);
+}
+
+uint32_t timer_ticks() {
+    return tick_count;
+}
+
+uint32_t timer_hz() {
+    return tick_hz;
+}
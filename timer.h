@@ -0,0 +1,16 @@
+// timer.h
+// PIT channel 0 periodic tick on IRQ0.
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "kernel.h"
+
+#define PIT_BASE_FREQUENCY 1193182
+#define TIMER_HZ           1000
+
+void timer_init(uint32_t hz);
+uint32_t timer_ticks();
+uint32_t timer_hz();
+
+#endif
@@ -0,0 +1,100 @@
+// tools/cold_check.c
+// Host check of entity storage under pressure: `make cold-check`.
+//
+//   cold_check
+//
+// Built with fewer resident entity slots than MAX_ENTITIES. Dormant
+// entities are left to freeze, which frees storage for spawns until the
+// pool is full. Then a waking entity walks round the ring, so every entity
+// in turn thaws into storage another has just given back by freezing.
+// Prints one line per step and exits non-zero if any fails:
+//   [CHECK] <step> ok|FAIL <detail>
+
+#include <stdio.h>
+
+#include "../holographic.h"
+#include "../coldstore.h"
+
+#define CHECK_IDLE_GENERATIONS  2
+#define CHECK_FILL_ROUNDS       (4 * MAX_ENTITIES)
+
+static int failures = 0;
+
+static void check(const char* step, int ok, uint32_t a, uint32_t b) {
+    printf("[CHECK] %s %s %u/%u\n", step, ok ? "ok" : "FAIL", a, b);
+    if (!ok) failures++;
+}
+
+static uint32_t count_cold() {
+    uint32_t cold = 0;
+    for (uint32_t i = 0; i < active_entity_count; i++) cold += entity_pool[i].is_cold;
+    return cold;
+}
+
+static void run_generations(uint32_t count) {
+    for (uint32_t g = 0; g < count; g++) {
+        holo_system.global_timestamp++;
+        update_entities();
+    }
+}
+
+int main(void) {
+    console_set_muted(1);
+    holo_cold_idle_generations = CHECK_IDLE_GENERATIONS;
+    initialize_holographic_memory();
+    load_initial_genome_vocabulary();
+    initialize_emergent_entities();
+
+    // Spawn into whatever storage is free, put everyone to sleep and let
+    // the sleepers freeze; the last round's spawns stay warm
+    uint32_t spawned = 0;
+    for (uint32_t round = 0; round < CHECK_FILL_ROUNDS; round++) {
+        while (spawn_entity()) spawned++;
+        for (uint32_t i = 0; i < active_entity_count; i++) entity_pool[i].is_active = 0;
+        if (active_entity_count == MAX_ENTITIES) break;
+        run_generations(CHECK_IDLE_GENERATIONS + 1);
+    }
+    check("spawn_past_resident_slots", active_entity_count == MAX_ENTITIES &&
+          MAX_ENTITIES > HOLO_RESIDENT_ENTITIES, active_entity_count, HOLO_RESIDENT_ENTITIES);
+    check("cold_share", count_cold() >= MAX_ENTITIES - HOLO_RESIDENT_ENTITIES,
+          count_cold(), MAX_ENTITIES - HOLO_RESIDENT_ENTITIES);
+
+    // Walk a waking entity once round the ring. Each round every warm
+    // entity but the walker freezes, then the walker wakes and its two cold
+    // neighbours thaw into the storage just freed; the next one along walks.
+    uint32_t walker = MAX_ENTITIES;
+    for (uint32_t i = 0; i < active_entity_count && walker == MAX_ENTITIES; i++) {
+        if (!entity_pool[i].is_cold) walker = i;
+    }
+    check("warm_entity", walker < MAX_ENTITIES, walker, active_entity_count);
+    if (walker == MAX_ENTITIES) return 1;
+
+    uint8_t thawed[MAX_ENTITIES] = { 0 };
+    uint32_t failed_thaws = 0;
+    for (uint32_t round = 0; round < MAX_ENTITIES; round++) {
+        for (uint32_t i = 0; i < active_entity_count; i++) entity_pool[i].is_active = 0;
+        for (uint32_t g = 0; g <= CHECK_IDLE_GENERATIONS; g++) {
+            entity_pool[walker].idle_generations = 0;
+            run_generations(1);
+        }
+        uint32_t sides[2] = { (walker + 1) % MAX_ENTITIES, (walker + MAX_ENTITIES - 1) % MAX_ENTITIES };
+        for (int n = 0; n < 2; n++) failed_thaws += !entity_pool[sides[n]].is_cold;
+        entity_pool[walker].is_active = 1;
+        run_generations(1);
+        for (int n = 0; n < 2; n++) {
+            struct Entity* neighbour = &entity_pool[sides[n]];
+            if (neighbour->is_cold || !neighbour->is_active) failed_thaws++;
+            else thawed[sides[n]] = 1;
+        }
+        walker = (walker + 1) % MAX_ENTITIES;
+    }
+    uint32_t thawed_count = 0;
+    for (uint32_t i = 0; i < MAX_ENTITIES; i++) thawed_count += thawed[i];
+    check("thaw_every_entity", failed_thaws == 0 && thawed_count == MAX_ENTITIES, thawed_count, MAX_ENTITIES);
+    check("storage_consistent", holographic_storage_rebuild() == 0, active_entity_count, count_cold());
+
+    console_set_muted(0);
+    cold_store_print_summary();
+    printf("[CHECK] %s spawned=%u\n", failures ? "FAILED" : "PASSED", spawned);
+    return failures ? 1 : 0;
+}
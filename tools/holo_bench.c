@@ -0,0 +1,17 @@
+// tools/holo_bench.c
+// Host driver for the micro-benchmark suite in bench.c.
+//
+//   holo_bench
+//
+// Prints the same [BENCH] lines the kernel emits with BENCH_ON_BOOT=1, so
+// runs can be diffed across commits. Pin it to one core (taskset -c N) for
+// stable numbers.
+
+#include "../bench.h"
+#include "../prefetch.h"
+
+int main(void) {
+    prefetch_init();
+    bench_run_all();
+    return 0;
+}
@@ -0,0 +1,129 @@
+// tools/holo_sim.c
+// Host driver for the simulation core (libholocore.a).
+//
+//   holo_sim [-g generations] [-d dimensions] [-s shards] [-c idle] [-f] [-v]
+//
+// Boots the same initial population as kmain (vocabulary, initial entities,
+// task path 0xA1 on the first two) and runs update_entities back to back,
+// advancing the timestamp as the kernel loop would between generations.
+// -f fills the memory pool with synthetic patterns first, so lookups scan
+// MAX_MEMORY_ENTRIES entries. -d picks the vector dimensionality, as the
+// kernel does at boot. -s splits the entity pool into that many shards, as
+// the kernel does per NUMA node, and prints a [SHARD] line for each so the
+// balancer can be watched. -c sets holo_cold_idle_generations, the idle
+// generations before a dormant entity moves to the cold store (0 = never);
+// the [COLD] line reports the store, and [GENOME] the genome store. Core
+// logging is muted unless -v is given.
+// Intended for `perf record` and `perf stat` at population sizes the kernel
+// image cannot hold; the sizing constants are set with -D at build time.
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../holographic.h"
+#include "../phase.h"
+#include "../hdr_histogram.h"
+#include "../prefetch.h"
+#include "../coldstore.h"
+#include "../genome.h"
+
+#define DEFAULT_GENERATIONS 1000
+#define TIMESTAMP_STEP      500001      // The kernel benchmark's BENCH_TIMESTAMP_STEP
+#define FILL_HEADROOM       16          // Pool slots left free by -f for spawns
+
+static double elapsed_seconds(const struct timespec* start, const struct timespec* end) {
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char** argv) {
+    uint32_t generations = DEFAULT_GENERATIONS;
+    int verbose = 0;
+    int fill = 0;
+    uint32_t shards = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            generations = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            if (holographic_set_dimensions((uint32_t)strtoul(argv[++i], NULL, 0)) != 0) {
+                fprintf(stderr, "%s: dimensions must be a multiple of %d up to %d\n",
+                        argv[0], HOLOGRAPHIC_DIMENSION_ALIGN, HOLOGRAPHIC_MAX_DIMENSIONS);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            shards = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            holo_cold_idle_generations = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-f") == 0) {
+            fill = 1;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-g generations] [-d dimensions] [-s shards] [-c idle] [-f] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    HdrHistogram generation_latency;
+    hdr_init(&generation_latency, "generation");
+    hdr_init(&encode_latency, "encode");
+    hdr_init(&retrieve_latency, "retrieve");
+
+    console_set_muted(!verbose);
+    prefetch_init();
+    holographic_partition_shards(shards, NULL);
+    initialize_holographic_memory();
+    load_initial_genome_vocabulary();
+    initialize_emergent_entities();
+
+    // Synthetic patterns land after the vocabulary, so the newest-first
+    // genome lookup in spawn_entity walks the whole filled pool
+    for (uint32_t i = 0; fill && holo_system.memory_count + FILL_HEADROOM < MAX_MEMORY_ENTRIES; i++) {
+        HolographicVector* pattern = holographic_scratch_vector(1);
+        create_holographic_vector(pattern, &i, sizeof(i));
+        encode_holographic_memory(pattern, pattern);
+    }
+
+    HolographicVector* path_vector = holographic_scratch_vector(1);
+    create_holographic_vector(path_vector, "network_io_path", strlen("network_io_path") + 1);
+    for (uint32_t i = 0; i < active_entity_count && i < 2; i++) {
+        holographic_vector_copy(&entity_pool[i].task_vector, path_vector);
+        entity_pool[i].path_id = 0xA1;
+    }
+
+    uint64_t entity_updates = 0;
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    for (uint32_t generation = 0; generation < generations; generation++) {
+        holo_system.global_timestamp += TIMESTAMP_STEP;
+        entity_updates += active_entity_count;
+        uint64_t start = platform_cycles();
+        update_entities();
+        hdr_record(&generation_latency, platform_cycles() - start);
+        phase_end_generation();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    console_set_muted(0);
+
+    double seconds = elapsed_seconds(&wall_start, &wall_end);
+    printf("[SIM] generations=%u dimensions=%u entities=%u memory_entries=%u seconds=%.6f gens_per_sec=%.1f"
+           " entity_updates_per_sec=%.0f footprint_bytes=%u\n",
+           generations, holo_dimensions, active_entity_count, holo_system.memory_count, seconds,
+           seconds > 0 ? generations / seconds : 0.0,
+           seconds > 0 ? entity_updates / seconds : 0.0,
+           holographic_footprint_bytes());
+    for (uint32_t s = 0; holo_shard_count > 1 && s < holo_shard_count; s++) {
+        const HoloShard* shard = &holo_shards[s];
+        printf("[SHARD] shard=%u first=%u slots=%u load=%u visits=%u halo_reads=%u migrated=%u\n",
+               s, shard->first, shard->count, shard->load, shard->visits, shard->halo_reads, shard->migrated);
+    }
+    phase_print_summary();
+    hdr_print(&generation_latency);
+    hdr_print(&encode_latency);
+    hdr_print(&retrieve_latency);
+    cold_store_print_summary();
+    genome_print_summary();
+    return 0;
+}
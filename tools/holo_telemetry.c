@@ -0,0 +1,151 @@
+// tools/holo_telemetry.c
+// Host-side viewer for the kernel's ivshmem telemetry region.
+//
+//   holo_telemetry [backing-file] [--once]
+//
+// The backing file is the memory-backend-file QEMU shares with the guest
+// (see `make run`). Prints one line per generation plus any trace records
+// published since the previous poll.
+
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../telemetry.h"
+
+#define DEFAULT_BACKING_FILE "/dev/shm/holo-telemetry"
+
+static const char* trace_kind_name(uint16_t kind) {
+    switch (kind) {
+    case TRACE_ACTIVATE:   return "ACTIVATE";
+    case TRACE_SLEEP:      return "SLEEP";
+    case TRACE_SPAWN:      return "SPAWN";
+    case TRACE_FITNESS:    return "FITNESS";
+    case TRACE_GC_MARK:    return "GC_MARK";
+    case TRACE_GC_COLLECT: return "GC_COLLECT";
+    case TRACE_FREEZE:     return "FREEZE";
+    case TRACE_THAW:       return "THAW";
+    default:               return "?";
+    }
+}
+
+static uint32_t load_seq(const volatile uint32_t* seq) {
+    uint32_t value = *seq;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return value;
+}
+
+// Seqlock read of the counters block and fitness column
+static void read_snapshot(const uint8_t* region, TelemetryCounters* counters, uint32_t* fitness) {
+    const volatile TelemetryHeader* header = (const volatile TelemetryHeader*)region;
+    for (;;) {
+        uint32_t before = load_seq(&header->seq);
+        if (before & 1) continue;
+        memcpy(counters, (const void*)&header->counters, sizeof(*counters));
+        uint32_t rows = counters->active_entities;
+        if (rows > header->pop_capacity) rows = header->pop_capacity;
+        memcpy(fitness, region + header->col_fitness, rows * sizeof(uint32_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (load_seq(&header->seq) == before) return;
+    }
+}
+
+static uint32_t drain_trace(const uint8_t* region, uint32_t next) {
+    const TelemetryHeader* header = (const TelemetryHeader*)region;
+    const volatile TelemetryTraceRing* ring =
+        (const volatile TelemetryTraceRing*)(region + header->trace_rings_offset);
+    const volatile TelemetryTraceRecord* records =
+        (const volatile TelemetryTraceRecord*)(region + ring->records_offset);
+
+    uint32_t head = load_seq(&ring->head);
+    if (head - next > ring->capacity) {
+        printf("  (trace overrun: %u records lost)\n", head - next - ring->capacity);
+        next = head - ring->capacity;
+    }
+
+    for (; next != head; next++) {
+        const volatile TelemetryTraceRecord* slot = &records[next & (ring->capacity - 1)];
+        TelemetryTraceRecord record;
+        memcpy(&record, (const void*)slot, sizeof(record));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (record.seq != next + 1 || load_seq(&slot->seq) != next + 1) continue;   // Overwritten
+        printf("  trace gen=%u ts=%u %-10s entity=%u arg=%u\n",
+               record.generation, record.timestamp, trace_kind_name(record.kind),
+               record.subject, record.arg);
+    }
+    return next;
+}
+
+int main(int argc, char** argv) {
+    const char* path = DEFAULT_BACKING_FILE;
+    int once = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--once") == 0) once = 1;
+        else path = argv[i];
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TelemetryHeader)) {
+        fprintf(stderr, "%s: too small for a telemetry region\n", path);
+        return 1;
+    }
+    const uint8_t* region = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    const volatile TelemetryHeader* header = (const volatile TelemetryHeader*)region;
+    while (header->magic != TELEMETRY_MAGIC) {
+        if (once) {
+            fprintf(stderr, "%s: kernel has not published telemetry yet\n", path);
+            return 1;
+        }
+        usleep(100000);
+    }
+    if (header->version != TELEMETRY_VERSION) {
+        fprintf(stderr, "telemetry version %u, expected %u\n", header->version, TELEMETRY_VERSION);
+        return 1;
+    }
+
+    uint32_t fitness[header->pop_capacity];
+    uint32_t last_generation = UINT32_MAX;
+    uint32_t trace_next = 0;
+
+    for (;;) {
+        TelemetryCounters counters;
+        read_snapshot(region, &counters, fitness);
+
+        if (counters.generation != last_generation) {
+            uint32_t best = 0;
+            for (uint32_t i = 0; i < counters.active_entities && i < header->pop_capacity; i++) {
+                if (fitness[i] > best) best = fitness[i];
+            }
+            uint64_t cycles = ((uint64_t)counters.last_generation_cycles_hi << 32) |
+                              counters.last_generation_cycles_lo;
+            printf("gen=%u ts=%u pop=%u awake=%u mutants=%u mem=%u spawns=%u/%u gc=%u/%u best_fit=%u cycles=%llu\n",
+                   counters.generation, counters.global_timestamp, counters.active_entities,
+                   counters.awake_entities, counters.mutant_entities, counters.memory_count,
+                   counters.generation_spawns, counters.total_spawns,
+                   counters.generation_collections, counters.total_collections,
+                   best, (unsigned long long)cycles);
+            last_generation = counters.generation;
+        }
+        trace_next = drain_trace(region, trace_next);
+        fflush(stdout);
+
+        if (once) break;
+        usleep(50000);
+    }
+    return 0;
+}
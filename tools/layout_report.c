@@ -0,0 +1,94 @@
+// tools/layout_report.c
+// Struct layout report for the kernel build: `make layout-report`.
+//
+// Never linked or run. The Makefile compiles this file to assembly with the
+// kernel CFLAGS (so -m32 and any -D sizing apply) and greps out the
+// "@@LAYOUT" markers, whose numbers the compiler substitutes as immediates:
+//   struct Entity size=128 align=64 lines=2
+//     .is_active offset=0 size=1 line=0 split=0
+// `line` is the cache line (CACHE_LINE_SIZE) the field starts on; split=1
+// means its last byte lands on a later line. Fields listed with
+// LAYOUT_HOT_FIELD also print hot=1, and the Makefile fails the report when
+// one of them is split.
+
+#include "../holographic.h"
+#include "../checkpoint.h"
+#include "../telemetry.h"
+
+#define LAYOUT_OFFSET(type, field) __builtin_offsetof(type, field)
+#define LAYOUT_SIZE(type, field)   sizeof(((type*)0)->field)
+#define LAYOUT_SPLIT(type, field) \
+    ((LAYOUT_OFFSET(type, field) / CACHE_LINE_SIZE) != \
+     ((LAYOUT_OFFSET(type, field) + LAYOUT_SIZE(type, field) - 1) / CACHE_LINE_SIZE))
+
+#define LAYOUT_STRUCT(type) \
+    __asm__ volatile(".ascii \"@@LAYOUT " #type " size=%c0 align=%c1 lines=%c2\"" \
+                     :: "i"(sizeof(type)), "i"(__alignof__(type)), \
+                        "i"((sizeof(type) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE))
+
+#define LAYOUT_FIELD(type, field) \
+    __asm__ volatile(".ascii \"@@LAYOUT   ." #field " offset=%c0 size=%c1 line=%c2 split=%c3\"" \
+                     :: "i"(LAYOUT_OFFSET(type, field)), "i"(LAYOUT_SIZE(type, field)), \
+                        "i"(LAYOUT_OFFSET(type, field) / CACHE_LINE_SIZE), \
+                        "i"(LAYOUT_SPLIT(type, field)))
+
+#define LAYOUT_HOT_FIELD(type, field) \
+    __asm__ volatile(".ascii \"@@LAYOUT   ." #field " offset=%c0 size=%c1 line=%c2 split=%c3 hot=1\"" \
+                     :: "i"(LAYOUT_OFFSET(type, field)), "i"(LAYOUT_SIZE(type, field)), \
+                        "i"(LAYOUT_OFFSET(type, field) / CACHE_LINE_SIZE), \
+                        "i"(LAYOUT_SPLIT(type, field)))
+
+void layout_report(void) {
+    LAYOUT_STRUCT(HolographicVector);
+    LAYOUT_FIELD(HolographicVector, data);
+    LAYOUT_FIELD(HolographicVector, hash_signature);
+    LAYOUT_FIELD(HolographicVector, active_dimensions);
+    LAYOUT_FIELD(HolographicVector, valid);
+
+    LAYOUT_STRUCT(MemoryEntry);
+    LAYOUT_FIELD(MemoryEntry, valid);
+    LAYOUT_FIELD(MemoryEntry, timestamp);
+    LAYOUT_FIELD(MemoryEntry, input_pattern);
+    LAYOUT_FIELD(MemoryEntry, output_pattern);
+
+    LAYOUT_STRUCT(GenomeEntry);
+    LAYOUT_FIELD(GenomeEntry, references);
+    LAYOUT_FIELD(GenomeEntry, content_hash);
+    LAYOUT_FIELD(GenomeEntry, next);
+    LAYOUT_FIELD(GenomeEntry, vector);
+
+    LAYOUT_STRUCT(struct Entity);
+    LAYOUT_HOT_FIELD(struct Entity, is_active);
+    LAYOUT_HOT_FIELD(struct Entity, marked_for_gc);
+    LAYOUT_HOT_FIELD(struct Entity, is_mutant);
+    LAYOUT_HOT_FIELD(struct Entity, is_cold);
+    LAYOUT_HOT_FIELD(struct Entity, id);
+    LAYOUT_HOT_FIELD(struct Entity, age);
+    LAYOUT_HOT_FIELD(struct Entity, interaction_count);
+    LAYOUT_HOT_FIELD(struct Entity, idle_generations);
+    LAYOUT_HOT_FIELD(struct Entity, fitness_score);
+    LAYOUT_HOT_FIELD(struct Entity, spawn_count);
+    LAYOUT_HOT_FIELD(struct Entity, path_id);
+    LAYOUT_HOT_FIELD(struct Entity, domain);
+    LAYOUT_HOT_FIELD(struct Entity, task_alignment);
+    LAYOUT_HOT_FIELD(struct Entity, genome);
+    LAYOUT_HOT_FIELD(struct Entity, state);
+    LAYOUT_HOT_FIELD(struct Entity, task_vector);
+    LAYOUT_FIELD(struct Entity, specialization_scores);
+    LAYOUT_FIELD(struct Entity, resource_allocation);
+    LAYOUT_FIELD(struct Entity, confidence);
+    LAYOUT_FIELD(struct Entity, cold_record);
+
+    LAYOUT_STRUCT(struct HolographicSystem);
+    LAYOUT_FIELD(struct HolographicSystem, memory_pool);
+    LAYOUT_FIELD(struct HolographicSystem, memory_count);
+    LAYOUT_FIELD(struct HolographicSystem, global_timestamp);
+    LAYOUT_FIELD(struct HolographicSystem, genomes);
+    LAYOUT_FIELD(struct HolographicSystem, genome_buckets);
+    LAYOUT_FIELD(struct HolographicSystem, genome_count);
+
+    LAYOUT_STRUCT(HdrHistogram);
+    LAYOUT_STRUCT(CheckpointHeader);
+    LAYOUT_STRUCT(TelemetryHeader);
+    LAYOUT_STRUCT(TelemetryTraceRing);
+}
@@ -0,0 +1,80 @@
+// tools/platform_host.c
+// Hosted implementation of the platform layer (see platform.h): console
+// output on stdout and no-op stand-ins for the kernel-only telemetry and PMU
+// drivers. On the host, `perf` is the hardware counter interface.
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <time.h>
+
+#include "../platform.h"
+#include "../pmu.h"
+#include "../telemetry.h"
+
+static int console_muted = 0;
+
+void console_set_muted(int muted) {
+    console_muted = muted;
+}
+
+void serial_print(const char* str) {
+    if (console_muted) return;
+    fputs(str, stdout);
+}
+
+void serial_print_hex(uint32_t value) {
+    if (console_muted) return;
+    printf("0x%08X", value);
+}
+
+void serial_print_dec(uint32_t value) {
+    if (console_muted) return;
+    printf("%u", value);
+}
+
+void serial_print_dec64(uint64_t value) {
+    if (console_muted) return;
+    printf("%llu", (unsigned long long)value);
+}
+
+void print(const char* str) {
+    serial_print(str);
+}
+
+void print_hex(uint32_t value) {
+    serial_print_hex(value);
+}
+
+uint64_t platform_monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void telemetry_trace(uint16_t kind, uint32_t subject, uint32_t arg) {
+    (void)kind;
+    (void)subject;
+    (void)arg;
+}
+
+int pmu_init() {
+    return 0;
+}
+
+int pmu_present() {
+    return 0;
+}
+
+int pmu_event_enabled(int event) {
+    (void)event;
+    return 0;
+}
+
+const char* pmu_event_name(int event) {
+    (void)event;
+    return "none";
+}
+
+void pmu_read(uint64_t values[PMU_EVENT_COUNT]) {
+    for (int event = 0; event < PMU_EVENT_COUNT; event++) values[event] = 0;
+}
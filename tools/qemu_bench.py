@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Run a benchmark kernel under QEMU and collect its serial results.
+
+Usage: qemu_bench.py [--timeout SECS] [--json OUT] [--log OUT] -- qemu args...
+
+Expects an image built with BENCH_GENERATIONS > 0 (see `make bench`) and a
+QEMU command line with `-serial stdio` and `-device isa-debug-exit`. Parses
+the [BOOT], [RESULT], [STATS], [HDR], [WDOG] and [BENCH] lines, adds host-side wall
+times (QEMU start to kernel ready, and to exit) and prints a JSON summary.
+Exits non-zero if the kernel did not report success.
+"""
+
+import json
+import queue
+import subprocess
+import sys
+import threading
+import time
+
+# isa-debug-exit status for BENCH_EXIT_SUCCESS (0): (0 << 1) | 1
+QEMU_EXIT_SUCCESS = 1
+
+
+def parse_fields(text):
+    """'a=1 b=2' -> {'a': 1, 'b': 2}; non-numeric values stay strings."""
+    fields = {}
+    for token in text.split():
+        if "=" not in token:
+            continue
+        key, value = token.split("=", 1)
+        try:
+            fields[key] = int(value)
+        except ValueError:
+            fields[key] = value
+    return fields
+
+
+def parse_line(line, results):
+    if line.startswith("[RESULT] ") and not line.startswith("[RESULT] END"):
+        results["result"].update(parse_fields(line[len("[RESULT] "):]))
+    elif line.startswith("[BOOT] boot_cycles="):
+        results["result"].update(parse_fields(line[len("[BOOT] "):]))
+    elif line.startswith("[HDR] "):
+        name, _, rest = line[len("[HDR] "):].partition(" ")
+        results["latency"][name] = parse_fields(rest.replace(" cycles", ""))
+    elif line.startswith("[WDOG] generations="):
+        results["watchdog"] = parse_fields(line[len("[WDOG] "):])
+    elif line.startswith("[BENCH] ") and "cycles_per_op=" in line:
+        name, _, rest = line[len("[BENCH] "):].partition(" ")
+        results["micro"].append(dict(name=name, **parse_fields(rest)))
+    elif line.startswith("[STATS] "):
+        parts = line[len("[STATS] "):].split()
+        # Phase rows: name gens avg min max share% (TSC table) or
+        # name ipc llc_mpki br_mpki (PMU table)
+        if len(parts) == 6 and parts[1].isdigit():
+            results["phases"][parts[0]] = dict(zip(
+                ("generations", "avg_cycles", "min_cycles", "max_cycles", "share_percent"),
+                (int(p) for p in parts[1:])))
+        elif len(parts) == 4 and parts[1].isdigit() and parts[0] in results["phases"]:
+            results["phases"][parts[0]].update(zip(
+                ("ipc_x100", "llc_mpki_x100", "br_mpki_x100"), (int(p) for p in parts[1:])))
+
+
+def read_lines(stream, lines):
+    """Reader thread: forwards stream lines, then None at EOF."""
+    for line in stream:
+        lines.put(line)
+    lines.put(None)
+
+
+def main(argv):
+    timeout, json_path, log_path = 600.0, None, None
+    if "--" not in argv:
+        print(__doc__, file=sys.stderr)
+        return 2
+    split = argv.index("--")
+    options, command = argv[1:split], argv[split + 1:]
+    while options:
+        option = options.pop(0)
+        if option == "--timeout":
+            timeout = float(options.pop(0))
+        elif option == "--json":
+            json_path = options.pop(0)
+        elif option == "--log":
+            log_path = options.pop(0)
+        else:
+            print(__doc__, file=sys.stderr)
+            return 2
+
+    results = {"result": {}, "phases": {}, "latency": {}, "micro": [], "watchdog": {}, "host": {}}
+    log = open(log_path, "w") if log_path else None
+    start = time.monotonic()
+    proc = subprocess.Popen(command, stdout=subprocess.PIPE, stdin=subprocess.DEVNULL,
+                            text=True, errors="replace")
+    # Lines come through a reader thread so a guest that hangs without
+    # printing still runs into the deadline
+    lines = queue.Queue()
+    threading.Thread(target=read_lines, args=(proc.stdout, lines), daemon=True).start()
+    deadline = start + timeout
+    timed_out = False
+    try:
+        while True:
+            try:
+                line = lines.get(timeout=max(0.0, deadline - time.monotonic()))
+            except queue.Empty:
+                timed_out = True
+                break
+            if line is None:
+                break
+            if log:
+                log.write(line)
+            line = line.strip()
+            if line.startswith("[BOOT] Kernel fully initialized"):
+                results["host"]["boot_wall_seconds"] = round(time.monotonic() - start, 3)
+            parse_line(line, results)
+        if timed_out:
+            proc.kill()
+            status = proc.wait()
+        else:
+            try:
+                status = proc.wait(timeout=max(1.0, deadline - time.monotonic()))
+            except subprocess.TimeoutExpired:
+                timed_out = True
+                proc.kill()
+                status = proc.wait()
+    finally:
+        if log:
+            log.close()
+
+    results["host"]["wall_seconds"] = round(time.monotonic() - start, 3)
+    results["host"]["qemu_status"] = status
+    results["host"]["timed_out"] = timed_out
+    ok = status == QEMU_EXIT_SUCCESS and "gens_per_sec" in results["result"]
+    results["ok"] = ok
+
+    text = json.dumps(results, indent=2, sort_keys=True)
+    print(text)
+    if json_path:
+        with open(json_path, "w") as f:
+            f.write(text + "\n")
+    if not ok:
+        print("qemu_bench: run failed (status %d%s)" % (status, ", timed out" if timed_out else ""),
+              file=sys.stderr)
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
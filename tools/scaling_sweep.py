@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Scaling sweep of the simulation core over its sizing constants.
+
+Usage: scaling_sweep.py [--entities 32,256,1024] [--dims 128,512,2048]
+                        [--memory 128,1024] [--generations N] [--csv OUT]
+
+For every (entities x dimensions x memory entries) point, builds the host
+core with MAX_ENTITIES / HOLOGRAPHIC_DIMENSIONS / MAX_MEMORY_ENTRIES set via
+-D (INITIAL_ENTITIES is half the pool, leaving room to spawn), runs the same
+fixed workload with `holo_sim -f` and prints one table row: mean and p99
+generation time, generations/s, entity updates/s and static footprint.
+
+The cores column is always 1: the kernel has no SMP bring-up and the core
+is single-threaded, so there is nothing to scale across yet.
+"""
+
+import os
+import subprocess
+import sys
+
+DEFAULTS = {
+    "entities": [32, 256, 1024],
+    "dims": [128, 512, 2048],
+    "memory": [128, 1024],
+    "generations": 300,     # Below the GC age (1000), so populations stay put
+}
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def parse_fields(text):
+    fields = {}
+    for token in text.split():
+        if "=" in token:
+            key, value = token.split("=", 1)
+            try:
+                fields[key] = float(value)
+            except ValueError:
+                fields[key] = value
+    return fields
+
+
+def build(entities, dims, memory):
+    build_dir = "host-build/sweep-e%d-d%d-m%d" % (entities, dims, memory)
+    binary = build_dir + "/holo_sim"
+    defines = "-DMAX_ENTITIES=%d -DINITIAL_ENTITIES=%d -DHOLOGRAPHIC_DIMENSIONS=%d -DMAX_MEMORY_ENTRIES=%d" % (
+        entities, max(1, entities // 2), dims, memory)
+    result = subprocess.run(["make", "-s", "HOST_BUILD=" + build_dir, "HOST_SIM=" + binary,
+                             "HOST_DEFINES=" + defines, binary],
+                            cwd=REPO, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        raise SystemExit("scaling_sweep: build failed for " + build_dir)
+    return os.path.join(REPO, binary)
+
+
+def run(binary, generations):
+    out = subprocess.run([binary, "-f", "-g", str(generations)],
+                         check=True, capture_output=True, text=True).stdout
+    sim, p99 = {}, 0
+    for line in out.splitlines():
+        if line.startswith("[SIM] "):
+            sim = parse_fields(line[len("[SIM] "):])
+        elif line.startswith("[HDR] generation "):
+            p99 = parse_fields(line).get("p99", 0)
+    return sim, p99
+
+
+def main(argv):
+    config = dict(DEFAULTS)
+    csv_path = None
+    args = argv[1:]
+    while args:
+        option = args.pop(0)
+        if option in ("--entities", "--dims", "--memory"):
+            config[option[2:]] = [int(v) for v in args.pop(0).split(",")]
+        elif option == "--generations":
+            config["generations"] = int(args.pop(0))
+        elif option == "--csv":
+            csv_path = args.pop(0)
+        else:
+            print(__doc__, file=sys.stderr)
+            return 2
+
+    columns = ("entities", "dims", "memory", "cores", "gen_us", "p99_kcycles",
+               "gens_per_sec", "entity_updates_per_sec", "footprint_kb")
+    header = "%8s %6s %7s %5s %10s %11s %12s %22s %12s" % columns
+    print(header)
+    rows = []
+    for entities in config["entities"]:
+        for dims in config["dims"]:
+            for memory in config["memory"]:
+                binary = build(entities, dims, memory)
+                sim, p99 = run(binary, config["generations"])
+                seconds = sim.get("seconds", 0.0)
+                row = (entities, dims, memory, 1,
+                       seconds * 1e6 / config["generations"],
+                       p99 / 1000.0,
+                       sim.get("gens_per_sec", 0.0),
+                       sim.get("entity_updates_per_sec", 0.0),
+                       sim.get("footprint_bytes", 0.0) / 1024.0)
+                rows.append(row)
+                print("%8d %6d %7d %5d %10.1f %11.1f %12.1f %22.0f %12.0f" % row, flush=True)
+
+    if csv_path:
+        with open(csv_path, "w") as f:
+            f.write(",".join(columns) + "\n")
+            for row in rows:
+                f.write(",".join(str(v) for v in row) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
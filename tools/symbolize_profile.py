@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Symbolize the kernel sampling profiler's serial dumps.
+
+Usage: symbolize_profile.py kernel.elf serial.log [--folded OUT]
+
+Reads the last "[PROF] BEGIN ... [PROF] END" block of every CPU from the
+serial capture, resolves addresses with `nm` against kernel.elf and prints
+a flat self-time profile. --folded writes "caller;...;leaf count" lines
+for flamegraph.pl.
+"""
+
+import bisect
+import subprocess
+import sys
+from collections import Counter
+
+
+def load_symbols(elf):
+    out = subprocess.run(["nm", "-n", "--defined-only", elf],
+                         check=True, capture_output=True, text=True).stdout
+    addrs, names = [], []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[1] in "tTwW":
+            addrs.append(int(parts[0], 16))
+            names.append(parts[2])
+    return addrs, names
+
+
+def resolve(symbols, addr):
+    addrs, names = symbols
+    i = bisect.bisect_right(addrs, addr) - 1
+    return names[i] if i >= 0 else "0x%08x" % addr
+
+
+def parse_dumps(path):
+    """Returns {cpu: (header_fields, [(count, [addrs...])])} for the last dump per CPU."""
+    dumps, current, cpu, header = {}, None, None, None
+    with open(path, errors="replace") as f:
+        for line in f:
+            if not line.startswith("[PROF] "):
+                continue
+            body = line[len("[PROF] "):].split()
+            if body and body[0] == "BEGIN":
+                header = dict(kv.split("=", 1) for kv in body[1:])
+                cpu = int(header.get("cpu", 0))
+                current = []
+            elif body and body[0] == "END":
+                if current is not None:
+                    dumps[cpu] = (header, current)
+                current = None
+            elif current is not None and body:
+                current.append((int(body[0]), [int(a, 16) for a in body[1:]]))
+    return dumps
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__, file=sys.stderr)
+        return 2
+    elf, log = argv[1], argv[2]
+    folded_path = argv[argv.index("--folded") + 1] if "--folded" in argv else None
+
+    symbols = load_symbols(elf)
+    dumps = parse_dumps(log)
+    if not dumps:
+        print("no [PROF] dump found in %s" % log, file=sys.stderr)
+        return 1
+
+    folded = Counter()
+    for cpu, (header, stacks) in sorted(dumps.items()):
+        total = sum(count for count, _ in stacks) or 1
+        self_time = Counter()
+        for count, frames in stacks:
+            # Callers are return addresses; step back into the call instruction
+            names = [resolve(symbols, a if depth == 0 else a - 1)
+                     for depth, a in enumerate(frames)]
+            self_time[names[0]] += count
+            folded[";".join(reversed(names))] += count
+
+        print("cpu %d: %s samples at %s Hz (%s dropped)" %
+              (cpu, header.get("samples"), header.get("hz"), header.get("dropped")))
+        print("  %8s %7s  %s" % ("samples", "self%", "function"))
+        for name, count in self_time.most_common():
+            print("  %8d %6.2f%%  %s" % (count, 100.0 * count / total, name))
+
+    if folded_path:
+        with open(folded_path, "w") as f:
+            for stack, count in folded.most_common():
+                f.write("%s %d\n" % (stack, count))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,263 @@
+// vecmath.c
+// The SSE paths are compiled per function (target attribute), so the rest
+// of the kernel keeps building without -msse. Batched loops run four lanes
+// at a time with unaligned loads and finish the tail with the scalar form.
+
+#include "platform.h"
+#include "vecmath.h"
+
+static int vecmath_selected = -1;
+
+static void vecmath_resolve_sqrt();
+static float vecmath_sqrt_detect(float x);
+float (*vecmath_sqrt_positive)(float x) = vecmath_sqrt_detect;
+
+static const char* const vecmath_level_names[] = { "soft", "x87", "sse" };
+
+static void vecmath_detect() {
+#if defined(__i386__) || defined(__x86_64__)
+#if !__STDC_HOSTED__
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if (edx & (1u << 25)) sse_enable();
+#endif
+    vecmath_selected = platform_sse_usable() ? VECMATH_SSE : VECMATH_X87;
+#else
+    vecmath_selected = VECMATH_SOFT;
+#endif
+    vecmath_resolve_sqrt();
+}
+
+int vecmath_init() {
+    vecmath_detect();
+    serial_print("[MATH] level=");
+    serial_print(vecmath_level_names[vecmath_selected]);
+    serial_print("\n");
+    return vecmath_selected;
+}
+
+int vecmath_level() {
+    if (vecmath_selected < 0) vecmath_detect();
+    return vecmath_selected;
+}
+
+const char* vecmath_level_name() {
+    return vecmath_level_names[vecmath_level()];
+}
+
+// --- Portable fallback ---
+// Bit-level initial guess for 1/sqrt(x), then Newton steps to full precision
+static float soft_rsqrt(float x) {
+    union { float f; uint32_t u; } bits = { x };
+    bits.u = 0x5f375a86 - (bits.u >> 1);
+    float y = bits.f;
+    for (int i = 0; i < 3; i++) {
+        y = y * (1.5f - 0.5f * x * y * y);
+    }
+    return y;
+}
+
+static float soft_sqrt(float x) {
+    return x * soft_rsqrt(x);
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+
+// --- x87 ---
+static float x87_sqrt(float x) {
+    float result;
+    __asm__("fsqrt" : "=t"(result) : "0"(x));
+    return result;
+}
+
+// --- SSE ---
+typedef float vm_v4sf __attribute__((vector_size(16)));
+typedef float vm_v4sf_u __attribute__((vector_size(16), aligned(1)));
+
+// The kernel's i386 stack is only 4-byte aligned; every SSE function
+// realigns so spilled vectors land on 16-byte slots
+#define VECMATH_SSE_FUNCTION __attribute__((target("sse"), force_align_arg_pointer))
+
+VECMATH_SSE_FUNCTION
+static float sse_sqrt(float x) {
+    vm_v4sf v = { x, 0.0f, 0.0f, 0.0f };
+    return __builtin_ia32_sqrtss(v)[0];
+}
+
+// rsqrtps is good to ~12 bits; one Newton step y' = y(1.5 - 0.5xy^2)
+// brings it to ~23
+VECMATH_SSE_FUNCTION
+static vm_v4sf sse_rsqrt4(vm_v4sf x) {
+    const vm_v4sf half = { 0.5f, 0.5f, 0.5f, 0.5f };
+    const vm_v4sf three_halves = { 1.5f, 1.5f, 1.5f, 1.5f };
+    vm_v4sf y = __builtin_ia32_rsqrtps(x);
+    return y * (three_halves - half * x * y * y);
+}
+
+// rcpps plus one Newton step y' = y(2 - xy)
+VECMATH_SSE_FUNCTION
+static vm_v4sf sse_reciprocal4(vm_v4sf x) {
+    const vm_v4sf two = { 2.0f, 2.0f, 2.0f, 2.0f };
+    vm_v4sf y = __builtin_ia32_rcpps(x);
+    return y * (two - x * y);
+}
+
+VECMATH_SSE_FUNCTION
+static void sse_sqrt_batch(float* out, const float* in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        *(vm_v4sf_u*)&out[i] = __builtin_ia32_sqrtps(*(const vm_v4sf_u*)&in[i]);
+    }
+    for (; i < count; i++) out[i] = sse_sqrt(in[i]);
+}
+
+VECMATH_SSE_FUNCTION
+static void sse_rsqrt_batch(float* out, const float* in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        *(vm_v4sf_u*)&out[i] = sse_rsqrt4(*(const vm_v4sf_u*)&in[i]);
+    }
+    for (; i < count; i++) {
+        vm_v4sf v = { in[i], 1.0f, 1.0f, 1.0f };
+        out[i] = sse_rsqrt4(v)[0];
+    }
+}
+
+VECMATH_SSE_FUNCTION
+static void sse_reciprocal_batch(float* out, const float* in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        *(vm_v4sf_u*)&out[i] = sse_reciprocal4(*(const vm_v4sf_u*)&in[i]);
+    }
+    for (; i < count; i++) {
+        vm_v4sf v = { in[i], 1.0f, 1.0f, 1.0f };
+        out[i] = sse_reciprocal4(v)[0];
+    }
+}
+
+VECMATH_SSE_FUNCTION
+static float sse_sum(const float* values, uint32_t count, int squares) {
+    vm_v4sf acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vm_v4sf v = *(const vm_v4sf_u*)&values[i];
+        acc += squares ? v * v : v;
+    }
+    float sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    for (; i < count; i++) sum += squares ? values[i] * values[i] : values[i];
+    return sum;
+}
+
+VECMATH_SSE_FUNCTION
+static void sse_scale(float* values, uint32_t count, float factor) {
+    vm_v4sf scale = { factor, factor, factor, factor };
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        *(vm_v4sf_u*)&values[i] = *(const vm_v4sf_u*)&values[i] * scale;
+    }
+    for (; i < count; i++) values[i] *= factor;
+}
+
+#define VECMATH_HAS_SSE() (vecmath_level() == VECMATH_SSE)
+#define VECMATH_HAS_X87() (vecmath_level() == VECMATH_X87)
+
+#else
+
+#define VECMATH_HAS_SSE() 0
+#define VECMATH_HAS_X87() 0
+
+#endif
+
+// --- Dispatch ---
+
+// The scalar sqrt is called once per alignment, so its level is resolved
+// into vecmath_sqrt_positive instead of being tested on every call
+static void vecmath_resolve_sqrt() {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) { vecmath_sqrt_positive = sse_sqrt; return; }
+    if (VECMATH_HAS_X87()) { vecmath_sqrt_positive = x87_sqrt; return; }
+#endif
+    vecmath_sqrt_positive = soft_sqrt;
+}
+
+static float vecmath_sqrt_detect(float x) {
+    vecmath_level();
+    return vecmath_sqrt_positive(x);
+}
+
+float vm_rsqrt(float x) {
+    float result;
+    vm_rsqrt_batch(&result, &x, 1);
+    return result;
+}
+
+float vm_reciprocal(float x) {
+    float result;
+    vm_reciprocal_batch(&result, &x, 1);
+    return result;
+}
+
+void vm_sqrt_batch(float* out, const float* in, uint32_t count) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) {
+        sse_sqrt_batch(out, in, count);
+        return;
+    }
+#endif
+    for (uint32_t i = 0; i < count; i++) out[i] = vm_sqrt(in[i]);
+}
+
+void vm_rsqrt_batch(float* out, const float* in, uint32_t count) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) {
+        sse_rsqrt_batch(out, in, count);
+        return;
+    }
+    if (VECMATH_HAS_X87()) {
+        for (uint32_t i = 0; i < count; i++) out[i] = 1.0f / x87_sqrt(in[i]);
+        return;
+    }
+#endif
+    for (uint32_t i = 0; i < count; i++) out[i] = soft_rsqrt(in[i]);
+}
+
+void vm_reciprocal_batch(float* out, const float* in, uint32_t count) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) {
+        sse_reciprocal_batch(out, in, count);
+        return;
+    }
+#endif
+    for (uint32_t i = 0; i < count; i++) out[i] = 1.0f / in[i];
+}
+
+float vm_sum(const float* values, uint32_t count) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) return sse_sum(values, count, 0);
+#endif
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; i++) sum += values[i];
+    return sum;
+}
+
+float vm_sum_squares(const float* values, uint32_t count) {
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) return sse_sum(values, count, 1);
+#endif
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; i++) sum += values[i] * values[i];
+    return sum;
+}
+
+void vm_normalize(float* values, uint32_t count) {
+    float length_squared = vm_sum_squares(values, count);
+    if (length_squared <= 0.0f) return;
+    float factor = vm_rsqrt(length_squared);
+#if defined(__i386__) || defined(__x86_64__)
+    if (VECMATH_HAS_SSE()) {
+        sse_scale(values, count, factor);
+        return;
+    }
+#endif
+    for (uint32_t i = 0; i < count; i++) values[i] *= factor;
+}
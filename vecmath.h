@@ -0,0 +1,58 @@
+// vecmath.h
+// Small float math library for the simulation core: sqrt, rsqrt and
+// reciprocal (scalar and batched), normalize, and sum reductions.
+//
+// The implementation is picked once from CPUID: SSE (sqrtss/sqrtps, and
+// rsqrtps/rcpps refined with one Newton-Raphson step to ~23 bits), the x87
+// fsqrt/fdiv instructions, or portable C off x86. vecmath_init also turns
+// SSE on in the kernel; any call before it detects without logging.
+
+#ifndef VECMATH_H
+#define VECMATH_H
+
+#include "platform.h"
+
+#define VECMATH_SOFT    0       // Portable C (non-x86 hosts)
+#define VECMATH_X87     1
+#define VECMATH_SSE     2
+
+// Detects (and in the kernel enables) the best level and logs it.
+// Returns the VECMATH_* level.
+int vecmath_init();
+int vecmath_level();
+const char* vecmath_level_name();
+
+// Square root for x > 0 at the detected level; starts as a stub that
+// detects and then replaces itself
+extern float (*vecmath_sqrt_positive)(float x);
+
+// Correctly rounded square root; 0 for x <= 0. Inline sqrtss where the
+// compiler already targets SSE math (x86-64 hosts), otherwise one call
+// through vecmath_sqrt_positive.
+static inline float vm_sqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+#ifdef __SSE_MATH__
+    typedef float vm_sqrt_v4sf __attribute__((vector_size(16)));
+    vm_sqrt_v4sf v = { x, 0.0f, 0.0f, 0.0f };
+    return __builtin_ia32_sqrtss(v)[0];
+#else
+    return vecmath_sqrt_positive(x);
+#endif
+}
+
+// 1/sqrt(x) and 1/x for positive, finite x (relative error below 1e-6)
+float vm_rsqrt(float x);
+float vm_reciprocal(float x);
+
+// Batched forms; out may alias in
+void vm_sqrt_batch(float* out, const float* in, uint32_t count);
+void vm_rsqrt_batch(float* out, const float* in, uint32_t count);
+void vm_reciprocal_batch(float* out, const float* in, uint32_t count);
+
+float vm_sum(const float* values, uint32_t count);
+float vm_sum_squares(const float* values, uint32_t count);
+
+// Scales the vector to unit length; all-zero vectors are left as they are
+void vm_normalize(float* values, uint32_t count);
+
+#endif
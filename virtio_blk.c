@@ -0,0 +1,558 @@
+// virtio_blk.c
+// Polled virtio-blk driver used for checkpoint I/O.
+//
+// Both transports share one split virtqueue. Each in-flight request owns a
+// fixed three-descriptor chain (header, payload, status), so large transfers
+// are cut into VIRTIO_BLK_MAX_REQUEST_SECTORS pieces, published to the avail
+// ring together and announced with one notify per batch.
+//
+// Completion is polled only: the used ring is reaped by spinning, and the
+// device's interrupt is never routed through the IDT. Every caller waits
+// for its request anyway, and the pager's I/O runs inside the #PF handler
+// with interrupts off, where an IRQ-driven completion could never arrive.
+
+#include "kernel.h"
+#include "pci.h"
+#include "virtio_blk.h"
+
+// Device status bits
+#define VIRTIO_STATUS_ACKNOWLEDGE   0x01
+#define VIRTIO_STATUS_DRIVER        0x02
+#define VIRTIO_STATUS_DRIVER_OK     0x04
+#define VIRTIO_STATUS_FEATURES_OK   0x08
+#define VIRTIO_STATUS_FAILED        0x80
+
+// Feature bits
+#define VIRTIO_BLK_F_SIZE_MAX       1
+#define VIRTIO_BLK_F_FLUSH          9
+#define VIRTIO_F_VERSION_1          32
+
+// Legacy I/O register layout (BAR0, no MSI-X)
+#define VIRTIO_LEGACY_DEVICE_FEATURES  0x00
+#define VIRTIO_LEGACY_GUEST_FEATURES   0x04
+#define VIRTIO_LEGACY_QUEUE_PFN        0x08
+#define VIRTIO_LEGACY_QUEUE_SIZE       0x0C
+#define VIRTIO_LEGACY_QUEUE_SELECT     0x0E
+#define VIRTIO_LEGACY_QUEUE_NOTIFY     0x10
+#define VIRTIO_LEGACY_DEVICE_STATUS    0x12
+#define VIRTIO_LEGACY_ISR_STATUS       0x13
+#define VIRTIO_LEGACY_DEVICE_CONFIG    0x14
+
+// Modern common configuration layout (virtio 1.x, 4.1.4.3)
+#define VIRTIO_COMMON_DFSELECT      0x00
+#define VIRTIO_COMMON_DF            0x04
+#define VIRTIO_COMMON_GFSELECT      0x08
+#define VIRTIO_COMMON_GF            0x0C
+#define VIRTIO_COMMON_STATUS        0x14
+#define VIRTIO_COMMON_Q_SELECT      0x16
+#define VIRTIO_COMMON_Q_SIZE        0x18
+#define VIRTIO_COMMON_Q_ENABLE      0x1C
+#define VIRTIO_COMMON_Q_NOFF        0x1E
+#define VIRTIO_COMMON_Q_DESCLO      0x20
+#define VIRTIO_COMMON_Q_DESCHI      0x24
+#define VIRTIO_COMMON_Q_AVAILLO     0x28
+#define VIRTIO_COMMON_Q_AVAILHI     0x2C
+#define VIRTIO_COMMON_Q_USEDLO      0x30
+#define VIRTIO_COMMON_Q_USEDHI      0x34
+
+#define VIRTIO_PCI_CAP_COMMON_CFG   1
+#define VIRTIO_PCI_CAP_NOTIFY_CFG   2
+#define VIRTIO_PCI_CAP_DEVICE_CFG   4
+
+// virtio-blk device configuration
+#define VIRTIO_BLK_CFG_CAPACITY     0x00
+#define VIRTIO_BLK_CFG_SIZE_MAX     0x08
+
+// Request types
+#define VIRTIO_BLK_T_IN             0
+#define VIRTIO_BLK_T_OUT            1
+#define VIRTIO_BLK_T_FLUSH          4
+#define VIRTIO_BLK_S_OK             0
+
+// Descriptor flags
+#define VIRTQ_DESC_F_NEXT           1
+#define VIRTQ_DESC_F_WRITE          2
+#define VIRTQ_USED_F_NO_NOTIFY      1
+
+#define VIRTQ_ALIGN                 4096
+#define VIRTQ_MAX_SIZE              256
+#define VIRTIO_BLK_MAX_INFLIGHT     (VIRTQ_MAX_SIZE / 3)
+#define VIRTIO_BLK_POLL_LIMIT       100000000U
+
+struct virtq_desc {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+};
+
+struct virtq_avail {
+    uint16_t flags;
+    uint16_t idx;
+    uint16_t ring[];
+};
+
+struct virtq_used_elem {
+    uint32_t id;
+    uint32_t len;
+};
+
+struct virtq_used {
+    uint16_t flags;
+    uint16_t idx;
+    struct virtq_used_elem ring[];
+};
+
+struct virtio_blk_req_header {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+};
+
+struct VirtioBlkDevice {
+    PciDevice pci;
+    uint8_t present;
+    uint8_t modern;
+    uint8_t has_flush;
+
+    // Legacy transport
+    uint16_t io_base;
+
+    // Modern transport
+    uint32_t common_cfg;
+    uint32_t device_cfg;
+    uint32_t notify_addr;
+
+    // Split virtqueue 0
+    uint16_t queue_size;
+    uint16_t max_inflight;
+    struct virtq_desc* desc;
+    struct virtq_avail* avail;
+    struct virtq_used* used;
+    uint16_t avail_idx;
+    uint16_t last_used_idx;
+
+    uint64_t capacity;
+    uint32_t max_request_sectors;
+
+    // Request slots: slot s owns descriptors 3s..3s+2
+    uint16_t free_slots[VIRTIO_BLK_MAX_INFLIGHT];
+    uint16_t free_count;
+
+    struct VirtioBlkStats stats;
+};
+
+static struct VirtioBlkDevice blk_device;
+
+// Ring memory (legacy layout is the largest: desc + avail, page-aligned used)
+static uint8_t virtq_memory[3 * VIRTQ_ALIGN] __attribute__((aligned(VIRTQ_ALIGN)));
+static struct virtio_blk_req_header request_headers[VIRTIO_BLK_MAX_INFLIGHT];
+static volatile uint8_t request_status[VIRTIO_BLK_MAX_INFLIGHT];
+
+//---Transport helpers---
+static void blk_set_status(uint8_t status) {
+    if (blk_device.modern) {
+        mmio_write8(blk_device.common_cfg + VIRTIO_COMMON_STATUS, status);
+    } else {
+        outb(blk_device.io_base + VIRTIO_LEGACY_DEVICE_STATUS, status);
+    }
+}
+
+static uint8_t blk_get_status() {
+    if (blk_device.modern) {
+        return mmio_read8(blk_device.common_cfg + VIRTIO_COMMON_STATUS);
+    }
+    return inb(blk_device.io_base + VIRTIO_LEGACY_DEVICE_STATUS);
+}
+
+static uint32_t blk_config_read32(uint32_t offset) {
+    if (blk_device.modern) {
+        return mmio_read32(blk_device.device_cfg + offset);
+    }
+    return inl(blk_device.io_base + VIRTIO_LEGACY_DEVICE_CONFIG + offset);
+}
+
+static void blk_notify() {
+    if (blk_device.used->flags & VIRTQ_USED_F_NO_NOTIFY) return;
+    if (blk_device.modern) {
+        mmio_write16(blk_device.notify_addr, 0);
+    } else {
+        outw(blk_device.io_base + VIRTIO_LEGACY_QUEUE_NOTIFY, 0);
+    }
+}
+
+static void virtq_layout(uint16_t queue_size) {
+    uint32_t base = (uint32_t)virtq_memory;
+    uint32_t avail_end = base + 16 * queue_size + 6 + 2 * queue_size;
+
+    memset(virtq_memory, 0, sizeof(virtq_memory));
+    blk_device.queue_size = queue_size;
+    blk_device.desc = (struct virtq_desc*)base;
+    blk_device.avail = (struct virtq_avail*)(base + 16 * queue_size);
+    blk_device.used = (struct virtq_used*)((avail_end + VIRTQ_ALIGN - 1) & ~(VIRTQ_ALIGN - 1));
+    blk_device.avail_idx = 0;
+    blk_device.last_used_idx = 0;
+
+    blk_device.max_inflight = queue_size / 3;
+    if (blk_device.max_inflight > VIRTIO_BLK_MAX_INFLIGHT) {
+        blk_device.max_inflight = VIRTIO_BLK_MAX_INFLIGHT;
+    }
+
+    // Pre-link each slot's chain; only addresses and lengths change per request
+    for (uint16_t slot = 0; slot < blk_device.max_inflight; slot++) {
+        struct virtq_desc* d = &blk_device.desc[slot * 3];
+        d[0].addr = (uint32_t)&request_headers[slot];
+        d[0].len = sizeof(struct virtio_blk_req_header);
+        d[0].flags = VIRTQ_DESC_F_NEXT;
+        d[0].next = slot * 3 + 1;
+        d[1].flags = VIRTQ_DESC_F_NEXT;
+        d[1].next = slot * 3 + 2;
+        d[2].addr = (uint32_t)&request_status[slot];
+        d[2].len = 1;
+        d[2].flags = VIRTQ_DESC_F_WRITE;
+        blk_device.free_slots[slot] = slot;
+    }
+    blk_device.free_count = blk_device.max_inflight;
+}
+
+//---Legacy transport bring-up---
+static int virtio_blk_setup_legacy() {
+    uint8_t is_io = 0;
+    uint32_t bar0 = pci_bar_address(&blk_device.pci, 0, &is_io);
+    if (!is_io || bar0 == 0) {
+        serial_print("[VIRTIO] Legacy BAR0 is not an I/O port range.\n");
+        return 0;
+    }
+    blk_device.io_base = (uint16_t)bar0;
+    blk_device.modern = 0;
+
+    blk_set_status(0);
+    blk_set_status(VIRTIO_STATUS_ACKNOWLEDGE);
+    blk_set_status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+    uint32_t features = inl(blk_device.io_base + VIRTIO_LEGACY_DEVICE_FEATURES);
+    uint32_t accepted = features & ((1U << VIRTIO_BLK_F_SIZE_MAX) | (1U << VIRTIO_BLK_F_FLUSH));
+    outl(blk_device.io_base + VIRTIO_LEGACY_GUEST_FEATURES, accepted);
+    blk_device.has_flush = (accepted >> VIRTIO_BLK_F_FLUSH) & 1;
+
+    outw(blk_device.io_base + VIRTIO_LEGACY_QUEUE_SELECT, 0);
+    uint16_t queue_size = inw(blk_device.io_base + VIRTIO_LEGACY_QUEUE_SIZE);
+    if (queue_size == 0 || queue_size > VIRTQ_MAX_SIZE) {
+        serial_print("[VIRTIO] Unsupported legacy queue size: ");
+        serial_print_dec(queue_size);
+        serial_print("\n");
+        blk_set_status(VIRTIO_STATUS_FAILED);
+        return 0;
+    }
+
+    // Legacy devices dictate the queue size; the ring layout follows from it
+    virtq_layout(queue_size);
+    outl(blk_device.io_base + VIRTIO_LEGACY_QUEUE_PFN, (uint32_t)virtq_memory / VIRTQ_ALIGN);
+
+    if (accepted & (1U << VIRTIO_BLK_F_SIZE_MAX)) {
+        uint32_t size_max = blk_config_read32(VIRTIO_BLK_CFG_SIZE_MAX) / VIRTIO_BLK_SECTOR_SIZE;
+        if (size_max > 0 && size_max < blk_device.max_request_sectors) {
+            blk_device.max_request_sectors = size_max;
+        }
+    }
+    blk_device.capacity = blk_config_read32(VIRTIO_BLK_CFG_CAPACITY) |
+                          ((uint64_t)blk_config_read32(VIRTIO_BLK_CFG_CAPACITY + 4) << 32);
+
+    blk_set_status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER | VIRTIO_STATUS_DRIVER_OK);
+    return 1;
+}
+
+//---Modern transport bring-up---
+static int virtio_blk_find_modern_caps() {
+    const PciDevice* dev = &blk_device.pci;
+    uint32_t notify_base = 0;
+    uint32_t notify_multiplier = 0;
+
+    if (!(pci_config_read16(dev, PCI_STATUS) & PCI_STATUS_CAP_LIST)) return 0;
+
+    uint8_t cap = pci_config_read8(dev, PCI_CAPABILITY_PTR) & 0xFC;
+    while (cap) {
+        uint8_t cap_id = pci_config_read8(dev, cap);
+        uint8_t next = pci_config_read8(dev, cap + 1) & 0xFC;
+
+        if (cap_id == PCI_CAP_ID_VENDOR) {
+            uint8_t cfg_type = pci_config_read8(dev, cap + 3);
+            uint8_t bar = pci_config_read8(dev, cap + 4);
+            uint32_t offset = pci_config_read32(dev, cap + 8);
+            uint8_t is_io = 0;
+            uint32_t base = (bar < 6) ? pci_bar_address(dev, bar, &is_io) : 0;
+
+            if (base != 0 && !is_io) {
+                if (cfg_type == VIRTIO_PCI_CAP_COMMON_CFG) {
+                    blk_device.common_cfg = base + offset;
+                } else if (cfg_type == VIRTIO_PCI_CAP_NOTIFY_CFG) {
+                    notify_base = base + offset;
+                    notify_multiplier = pci_config_read32(dev, cap + 16);
+                } else if (cfg_type == VIRTIO_PCI_CAP_DEVICE_CFG) {
+                    blk_device.device_cfg = base + offset;
+                }
+            }
+        }
+        cap = next;
+    }
+
+    if (!blk_device.common_cfg || !notify_base || !blk_device.device_cfg) return 0;
+
+    mmio_write16(blk_device.common_cfg + VIRTIO_COMMON_Q_SELECT, 0);
+    uint16_t notify_off = mmio_read16(blk_device.common_cfg + VIRTIO_COMMON_Q_NOFF);
+    blk_device.notify_addr = notify_base + notify_off * notify_multiplier;
+    return 1;
+}
+
+static int virtio_blk_setup_modern() {
+    uint32_t common = blk_device.common_cfg;
+    blk_device.modern = 1;
+
+    blk_set_status(0);
+    for (uint32_t spin = 0; blk_get_status() != 0; spin++) {
+        if (spin > VIRTIO_BLK_POLL_LIMIT) return 0;
+        cpu_relax();
+    }
+    blk_set_status(VIRTIO_STATUS_ACKNOWLEDGE);
+    blk_set_status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+    mmio_write32(common + VIRTIO_COMMON_DFSELECT, 0);
+    uint32_t features_lo = mmio_read32(common + VIRTIO_COMMON_DF);
+    mmio_write32(common + VIRTIO_COMMON_DFSELECT, 1);
+    uint32_t features_hi = mmio_read32(common + VIRTIO_COMMON_DF);
+
+    if (!(features_hi & (1U << (VIRTIO_F_VERSION_1 - 32)))) {
+        blk_set_status(VIRTIO_STATUS_FAILED);
+        return 0;
+    }
+
+    uint32_t accepted_lo = features_lo & ((1U << VIRTIO_BLK_F_SIZE_MAX) | (1U << VIRTIO_BLK_F_FLUSH));
+    mmio_write32(common + VIRTIO_COMMON_GFSELECT, 0);
+    mmio_write32(common + VIRTIO_COMMON_GF, accepted_lo);
+    mmio_write32(common + VIRTIO_COMMON_GFSELECT, 1);
+    mmio_write32(common + VIRTIO_COMMON_GF, 1U << (VIRTIO_F_VERSION_1 - 32));
+    blk_device.has_flush = (accepted_lo >> VIRTIO_BLK_F_FLUSH) & 1;
+
+    uint8_t status = VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER | VIRTIO_STATUS_FEATURES_OK;
+    blk_set_status(status);
+    if (!(blk_get_status() & VIRTIO_STATUS_FEATURES_OK)) {
+        serial_print("[VIRTIO] Device rejected feature set.\n");
+        blk_set_status(VIRTIO_STATUS_FAILED);
+        return 0;
+    }
+
+    mmio_write16(common + VIRTIO_COMMON_Q_SELECT, 0);
+    uint16_t queue_size = mmio_read16(common + VIRTIO_COMMON_Q_SIZE);
+    if (queue_size == 0) {
+        blk_set_status(VIRTIO_STATUS_FAILED);
+        return 0;
+    }
+    if (queue_size > VIRTQ_MAX_SIZE) queue_size = VIRTQ_MAX_SIZE;
+
+    virtq_layout(queue_size);
+    mmio_write16(common + VIRTIO_COMMON_Q_SIZE, queue_size);
+    mmio_write32(common + VIRTIO_COMMON_Q_DESCLO, (uint32_t)blk_device.desc);
+    mmio_write32(common + VIRTIO_COMMON_Q_DESCHI, 0);
+    mmio_write32(common + VIRTIO_COMMON_Q_AVAILLO, (uint32_t)blk_device.avail);
+    mmio_write32(common + VIRTIO_COMMON_Q_AVAILHI, 0);
+    mmio_write32(common + VIRTIO_COMMON_Q_USEDLO, (uint32_t)blk_device.used);
+    mmio_write32(common + VIRTIO_COMMON_Q_USEDHI, 0);
+    mmio_write16(common + VIRTIO_COMMON_Q_ENABLE, 1);
+
+    if (accepted_lo & (1U << VIRTIO_BLK_F_SIZE_MAX)) {
+        uint32_t size_max = blk_config_read32(VIRTIO_BLK_CFG_SIZE_MAX) / VIRTIO_BLK_SECTOR_SIZE;
+        if (size_max > 0 && size_max < blk_device.max_request_sectors) {
+            blk_device.max_request_sectors = size_max;
+        }
+    }
+    blk_device.capacity = blk_config_read32(VIRTIO_BLK_CFG_CAPACITY) |
+                          ((uint64_t)blk_config_read32(VIRTIO_BLK_CFG_CAPACITY + 4) << 32);
+
+    blk_set_status(status | VIRTIO_STATUS_DRIVER_OK);
+    return 1;
+}
+
+int virtio_blk_init() {
+    memset(&blk_device, 0, sizeof(blk_device));
+    blk_device.max_request_sectors = VIRTIO_BLK_MAX_REQUEST_SECTORS;
+
+    int found = pci_find_device(VIRTIO_PCI_VENDOR_ID, VIRTIO_BLK_DEVICE_MODERN, &blk_device.pci) ||
+                pci_find_device(VIRTIO_PCI_VENDOR_ID, VIRTIO_BLK_DEVICE_LEGACY, &blk_device.pci);
+    if (!found) {
+        serial_print("[VIRTIO] No virtio-blk device found.\n");
+        return 0;
+    }
+
+    pci_enable(&blk_device.pci, PCI_COMMAND_IO | PCI_COMMAND_MEMORY | PCI_COMMAND_BUS_MASTER);
+
+    // Transitional devices expose both transports; prefer the modern one
+    int ready = 0;
+    if (virtio_blk_find_modern_caps()) {
+        ready = virtio_blk_setup_modern();
+    }
+    if (!ready && blk_device.pci.device_id == VIRTIO_BLK_DEVICE_LEGACY) {
+        ready = virtio_blk_setup_legacy();
+    }
+    if (!ready) {
+        serial_print("[VIRTIO] virtio-blk initialization failed.\n");
+        return 0;
+    }
+
+    blk_device.present = 1;
+    serial_print("[VIRTIO] virtio-blk online (");
+    serial_print(blk_device.modern ? "modern" : "legacy");
+    serial_print("), queue size ");
+    serial_print_dec(blk_device.queue_size);
+    serial_print(", capacity ");
+    serial_print_dec((uint32_t)blk_device.capacity);
+    serial_print(" sectors\n");
+    return 1;
+}
+
+int virtio_blk_present() {
+    return blk_device.present;
+}
+
+uint64_t virtio_blk_capacity() {
+    return blk_device.capacity;
+}
+
+const struct VirtioBlkStats* virtio_blk_get_stats() {
+    return &blk_device.stats;
+}
+
+//---Request engine---
+// Takes back the descriptor chains still posted when a request times out.
+// The reset makes the device drop the queue, so it no longer writes into
+// buffers the caller is about to reuse. The transport is then brought up
+// again on a fresh ring. If that fails, the disk goes offline.
+static void virtio_blk_reset() {
+    serial_print("[VIRTIO] Request timeout, resetting device.\n");
+    int ready = blk_device.modern ? virtio_blk_setup_modern() : virtio_blk_setup_legacy();
+    if (!ready) {
+        blk_device.present = 0;
+        serial_print("[VIRTIO] Reset failed, disk offline.\n");
+    }
+}
+
+static void virtq_submit(uint16_t slot, uint32_t type, uint32_t lba, uint32_t buffer, uint32_t sector_count) {
+    struct virtq_desc* d = &blk_device.desc[slot * 3];
+
+    request_headers[slot].type = type;
+    request_headers[slot].reserved = 0;
+    request_headers[slot].sector = lba;
+    request_status[slot] = 0xFF;
+
+    if (type == VIRTIO_BLK_T_FLUSH) {
+        d[0].next = slot * 3 + 2;   // No payload descriptor
+    } else {
+        d[0].next = slot * 3 + 1;
+        d[1].addr = buffer;
+        d[1].len = sector_count * VIRTIO_BLK_SECTOR_SIZE;
+        d[1].flags = VIRTQ_DESC_F_NEXT | (type == VIRTIO_BLK_T_IN ? VIRTQ_DESC_F_WRITE : 0);
+    }
+
+    blk_device.avail->ring[blk_device.avail_idx % blk_device.queue_size] = slot * 3;
+    blk_device.avail_idx++;
+}
+
+static int virtq_reap() {
+    int errors = 0;
+    while (blk_device.last_used_idx != *(volatile uint16_t*)&blk_device.used->idx) {
+        barrier();
+        struct virtq_used_elem* elem = &blk_device.used->ring[blk_device.last_used_idx % blk_device.queue_size];
+        uint16_t slot = elem->id / 3;
+
+        if (request_status[slot] != VIRTIO_BLK_S_OK) {
+            blk_device.stats.errors++;
+            errors++;
+        }
+        blk_device.stats.requests++;
+        blk_device.free_slots[blk_device.free_count++] = slot;
+        blk_device.last_used_idx++;
+    }
+    return errors;
+}
+
+static int virtio_blk_transfer(uint32_t type, uint32_t lba, uint32_t buffer, uint32_t sector_count) {
+    if (!blk_device.present) return -1;
+    if ((uint64_t)lba + sector_count > blk_device.capacity) {
+        serial_print("[VIRTIO] Transfer beyond end of disk.\n");
+        return -1;
+    }
+
+    int errors = 0;
+    uint32_t spins = 0;
+
+    while (sector_count > 0 || blk_device.free_count < blk_device.max_inflight) {
+        // Fill every free slot before ringing the doorbell once
+        uint16_t queued = 0;
+        while (sector_count > 0 && blk_device.free_count > 0) {
+            uint32_t chunk = sector_count;
+            if (chunk > blk_device.max_request_sectors) chunk = blk_device.max_request_sectors;
+
+            uint16_t slot = blk_device.free_slots[--blk_device.free_count];
+            virtq_submit(slot, type, lba, buffer, chunk);
+
+            lba += chunk;
+            buffer += chunk * VIRTIO_BLK_SECTOR_SIZE;
+            sector_count -= chunk;
+            blk_device.stats.sectors += chunk;
+            queued++;
+        }
+
+        if (queued) {
+            barrier();
+            blk_device.avail->idx = blk_device.avail_idx;
+            memory_fence();
+            blk_notify();
+            blk_device.stats.batches++;
+            spins = 0;
+        }
+
+        errors += virtq_reap();
+        if (++spins > VIRTIO_BLK_POLL_LIMIT) {
+            virtio_blk_reset();
+            return -1;
+        }
+        cpu_relax();
+    }
+
+    if (blk_device.modern == 0) {
+        inb(blk_device.io_base + VIRTIO_LEGACY_ISR_STATUS);   // Ack any raised interrupt
+    }
+    return errors ? -1 : 0;
+}
+
+int virtio_blk_read(uint32_t lba, void* buffer, uint32_t sector_count) {
+    return virtio_blk_transfer(VIRTIO_BLK_T_IN, lba, (uint32_t)buffer, sector_count);
+}
+
+int virtio_blk_write(uint32_t lba, const void* buffer, uint32_t sector_count) {
+    return virtio_blk_transfer(VIRTIO_BLK_T_OUT, lba, (uint32_t)buffer, sector_count);
+}
+
+int virtio_blk_flush() {
+    if (!blk_device.present) return -1;
+    if (!blk_device.has_flush) return 0;
+    if (blk_device.free_count == 0) return -1;
+
+    uint16_t slot = blk_device.free_slots[--blk_device.free_count];
+    virtq_submit(slot, VIRTIO_BLK_T_FLUSH, 0, 0, 0);
+    barrier();
+    blk_device.avail->idx = blk_device.avail_idx;
+    memory_fence();
+    blk_notify();
+    blk_device.stats.batches++;
+
+    int errors = 0;
+    for (uint32_t spins = 0; blk_device.free_count < blk_device.max_inflight; spins++) {
+        if (spins > VIRTIO_BLK_POLL_LIMIT) {
+            virtio_blk_reset();
+            return -1;
+        }
+        errors += virtq_reap();
+        cpu_relax();
+    }
+    return errors ? -1 : 0;
+}
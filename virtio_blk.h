@@ -0,0 +1,42 @@
+// virtio_blk.h
+// virtio-blk PCI driver (legacy and modern transports, split virtqueue,
+// polled completion).
+
+#ifndef VIRTIO_BLK_H
+#define VIRTIO_BLK_H
+
+#include "kernel.h"
+
+#define VIRTIO_PCI_VENDOR_ID        0x1AF4
+#define VIRTIO_BLK_DEVICE_LEGACY    0x1001  // Transitional device ID
+#define VIRTIO_BLK_DEVICE_MODERN    0x1042  // 0x1040 + VIRTIO_ID_BLOCK
+
+#define VIRTIO_BLK_SECTOR_SIZE      512
+
+// Upper bound on one request's payload; large pool transfers are split into
+// several of these and submitted as one batch with a single notify.
+#define VIRTIO_BLK_MAX_REQUEST_SECTORS 128
+
+struct VirtioBlkStats {
+    uint32_t requests;          // Requests completed
+    uint32_t batches;           // Queue notifications issued
+    uint32_t sectors;           // Sectors transferred
+    uint32_t errors;            // Requests that completed with a bad status
+};
+
+// Probes PCI for a virtio-blk device and brings it to DRIVER_OK.
+// Returns 1 when the disk is ready for I/O, 0 otherwise.
+int virtio_blk_init();
+int virtio_blk_present();
+uint64_t virtio_blk_capacity();   // In 512-byte sectors
+
+// Synchronous, polled transfers. Return 0 on success, -1 on error. A
+// request that times out resets the device, which drops whatever was still
+// queued; the disk stays usable if it comes back.
+int virtio_blk_read(uint32_t lba, void* buffer, uint32_t sector_count);
+int virtio_blk_write(uint32_t lba, const void* buffer, uint32_t sector_count);
+int virtio_blk_flush();
+
+const struct VirtioBlkStats* virtio_blk_get_stats();
+
+#endif
@@ -0,0 +1,152 @@
+// watchdog.c
+
+#include "kernel.h"
+#include "watchdog.h"
+#include "timer.h"
+#include "phase.h"
+
+typedef struct {
+    uint32_t generation;
+    uint64_t cycles;
+    int phase_at_deadline;
+    int heaviest_phase;
+} WatchdogOverrun;
+
+uint32_t watchdog_budget_ms = WATCHDOG_BUDGET_MS;
+uint32_t watchdog_shed_mask = WATCHDOG_SHED_DEFAULT;
+
+// Shared with the timer interrupt
+static volatile uint8_t armed = 0;
+static volatile uint8_t expired = 0;
+static volatile uint32_t deadline_ticks = 0;
+static volatile int phase_at_deadline = PHASE_NONE;
+
+static uint32_t armed_generation = 0;
+static uint32_t generations = 0;
+static uint32_t overruns = 0;
+static uint32_t shed_remaining = 0;
+// Index PHASE_COUNT counts overruns outside any phase
+static uint32_t at_deadline_counts[PHASE_COUNT + 1];
+static uint32_t heaviest_counts[PHASE_COUNT + 1];
+static WatchdogOverrun worst[WATCHDOG_WORST];
+static uint32_t worst_count = 0;
+
+static uint32_t ms_to_ticks(uint32_t ms) {
+    uint32_t ticks = ms * timer_hz() / 1000;
+    return ticks ? ticks : 1;
+}
+
+static uint32_t phase_slot(int phase) {
+    return (phase >= 0 && phase < PHASE_COUNT) ? (uint32_t)phase : PHASE_COUNT;
+}
+
+void watchdog_arm(uint32_t generation) {
+    if (watchdog_budget_ms == 0) return;
+    armed_generation = generation;
+    expired = 0;
+    phase_at_deadline = PHASE_NONE;
+    // +1: the first tick may land almost immediately after arming
+    deadline_ticks = timer_ticks() + ms_to_ticks(watchdog_budget_ms) + 1;
+    barrier();
+    armed = 1;
+}
+
+void watchdog_tick(uint32_t ticks) {
+    if (!armed || expired) return;
+    if ((int32_t)(ticks - deadline_ticks) >= 0) {
+        phase_at_deadline = phase_current();
+        expired = 1;
+    }
+}
+
+static void record_worst(const WatchdogOverrun* overrun) {
+    uint32_t slot = worst_count;
+    if (worst_count < WATCHDOG_WORST) {
+        worst_count++;
+    } else if (overrun->cycles <= worst[WATCHDOG_WORST - 1].cycles) {
+        return;
+    } else {
+        slot = WATCHDOG_WORST - 1;
+    }
+    // Insertion keeps the list sorted by descending cycles
+    while (slot > 0 && worst[slot - 1].cycles < overrun->cycles) {
+        worst[slot] = worst[slot - 1];
+        slot--;
+    }
+    worst[slot] = *overrun;
+}
+
+// Phase with the most cycles this generation (call before phase_end_generation)
+static int heaviest_phase() {
+    int heaviest = PHASE_NONE;
+    uint64_t most = 0;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        uint64_t cycles = phase_generation_cycles(phase);
+        if (cycles > most) {
+            most = cycles;
+            heaviest = phase;
+        }
+    }
+    return heaviest;
+}
+
+int watchdog_disarm(uint64_t generation_cycles) {
+    if (shed_remaining) shed_remaining--;
+    if (!armed) return 0;
+    armed = 0;
+    barrier();
+    generations++;
+    if (!expired) return 0;
+
+    WatchdogOverrun overrun;
+    overrun.generation = armed_generation;
+    overrun.cycles = generation_cycles;
+    overrun.phase_at_deadline = phase_at_deadline;
+    overrun.heaviest_phase = heaviest_phase();
+
+    overruns++;
+    at_deadline_counts[phase_slot(overrun.phase_at_deadline)]++;
+    heaviest_counts[phase_slot(overrun.heaviest_phase)]++;
+    record_worst(&overrun);
+    shed_remaining = WATCHDOG_SHED_GENERATIONS;
+    return 1;
+}
+
+int watchdog_shedding(uint32_t measure) {
+    return shed_remaining && (watchdog_shed_mask & measure);
+}
+
+void watchdog_print_summary() {
+    serial_print("[WDOG] generations=");
+    serial_print_dec(generations);
+    serial_print(" overruns=");
+    serial_print_dec(overruns);
+    serial_print(" budget_ms=");
+    serial_print_dec(watchdog_budget_ms);
+    serial_print(" shedding=");
+    serial_print_dec(shed_remaining);
+    serial_print("\n");
+    if (!overruns) return;
+
+    for (int slot = 0; slot <= PHASE_COUNT; slot++) {
+        if (!at_deadline_counts[slot] && !heaviest_counts[slot]) continue;
+        serial_print("[WDOG] phase ");
+        serial_print(phase_name(slot < PHASE_COUNT ? slot : PHASE_NONE));
+        serial_print(" at_deadline=");
+        serial_print_dec(at_deadline_counts[slot]);
+        serial_print(" heaviest=");
+        serial_print_dec(heaviest_counts[slot]);
+        serial_print("\n");
+    }
+    for (uint32_t i = 0; i < worst_count; i++) {
+        serial_print("[WDOG] worst generation=");
+        serial_print_dec(worst[i].generation);
+        serial_print(" cycles=");
+        serial_print_dec64(worst[i].cycles);
+        serial_print(" at_deadline=");
+        serial_print(phase_name(worst[i].phase_at_deadline));
+        serial_print(" heaviest=");
+        serial_print(phase_name(worst[i].heaviest_phase));
+        serial_print("\n");
+    }
+}
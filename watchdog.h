@@ -0,0 +1,48 @@
+// watchdog.h
+// Per-generation deadline watchdog.
+//
+// The main loop arms a deadline before update_entities and disarms it after
+// rendering. The timer interrupt checks the deadline every tick; when it
+// passes, the phase executing at that moment (phase_current) is recorded.
+// At disarm an overrun is charged to that phase and to the generation's
+// heaviest phase, and the worst overruns are kept for the summary:
+//   [WDOG] generations=<n> overruns=<n> budget_ms=<n> shedding=<n>
+//   [WDOG] phase <name> at_deadline=<n> heaviest=<n>
+//   [WDOG] worst generation=<n> cycles=<n> at_deadline=<phase> heaviest=<phase>
+//
+// After an overrun the loop may shed load for WATCHDOG_SHED_GENERATIONS
+// generations, as selected by the shed mask.
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include "kernel.h"
+
+#define WATCHDOG_BUDGET_MS          50      // Default deadline per generation
+#define WATCHDOG_SHED_GENERATIONS   8
+#define WATCHDOG_WORST              4       // Worst overruns kept for the summary
+
+// Shed mask bits
+#define WATCHDOG_SHED_RENDER    0x01    // Skip VGA rendering
+#define WATCHDOG_SHED_LOGGING   0x02    // Mute core chatter
+#define WATCHDOG_SHED_GC        0x04    // Defer GC compaction (breaks replay determinism)
+#define WATCHDOG_SHED_DEFAULT   (WATCHDOG_SHED_RENDER | WATCHDOG_SHED_LOGGING)
+
+// Runtime tunables (registered with the console by the kernel); a budget of
+// 0 disables the watchdog
+extern uint32_t watchdog_budget_ms;
+extern uint32_t watchdog_shed_mask;
+
+void watchdog_arm(uint32_t generation);
+// Returns 1 when the generation overran its deadline
+int watchdog_disarm(uint64_t generation_cycles);
+
+// Called from the timer interrupt
+void watchdog_tick(uint32_t ticks);
+
+// Nonzero while the given WATCHDOG_SHED_* measure is in effect
+int watchdog_shedding(uint32_t measure);
+
+void watchdog_print_summary();
+
+#endif